@@ -225,10 +225,15 @@ static int ime_register_command(lua_State * L){
     new_command.leading = "digit";
   }
 
-  if ( !lua_isnone(L, 5)) {
+  if ( !lua_isnoneornil(L, 5)) {
     new_command.help = luaL_checklstring(L, 5, NULL);
   }
 
+  if ( !lua_isnoneornil(L, 6)) {
+    luaL_checktype(L, 6, LUA_TBOOLEAN);
+    new_command.pure = lua_toboolean(L, 6);
+  }
+
   gboolean result = ibus_engine_plugin_add_command
     (lua_plugin_retrieve_plugin(L), &new_command);
 
@@ -238,45 +243,75 @@ static int ime_register_command(lua_State * L){
   return 0;
 }
 
-static int ime_register_trigger(lua_State * L){
-  const char * lua_function_name = luaL_checklstring(L, 1, NULL);
-  const char * description = luaL_checklstring(L, 2, NULL);
-  size_t num; size_t i;
-  fprintf(stderr, "TODO: ime_register_trigger unimplemented when called with %s (%s).\n", lua_function_name, description);
+static gchar ** ime_check_string_list(lua_State * L, int narg){
+  size_t num; size_t i; size_t n = 0;
+  const char * str;
+  gchar ** strings;
 
-  luaL_checktype(L, 3, LUA_TTABLE);
+  luaL_checktype(L, narg, LUA_TTABLE);
 
-  /* TODO: register_trigger with input_trigger_strings. */
-  num = lua_objlen(L, 3);
+  num = lua_objlen(L, narg);
+  strings = g_new0(gchar *, num + 1);
   for ( i = 0; i < num; ++i) {
     lua_pushinteger(L, i + 1);
-    lua_gettable(L, 3);
-    fprintf(stderr, "%d:%s\t", (int)i + 1, lua_tostring(L, -1));
+    lua_gettable(L, narg);
+    str = lua_tostring(L, -1);
+    if ( str )
+      strings[n++] = g_strdup(str);
     lua_pop(L, 1);
   }
-  fprintf(stderr, "\n");
 
+  return strings;
+}
+
+static int ime_register_trigger(lua_State * L){
+  lua_trigger_t new_trigger;
+  gboolean result;
+
+  memset(&new_trigger, 0, sizeof(new_trigger));
+  new_trigger.lua_function_name = luaL_checklstring(L, 1, NULL);
+  lua_getglobal(L, new_trigger.lua_function_name);
+  luaL_checktype(L, -1, LUA_TFUNCTION);
+  lua_pop(L, 1);
+
+  new_trigger.description = luaL_checklstring(L, 2, NULL);
+
+  luaL_checktype(L, 3, LUA_TTABLE);
   luaL_checktype(L, 4, LUA_TTABLE);
+  new_trigger.input_trigger_strings = ime_check_string_list(L, 3);
+  new_trigger.candidate_trigger_strings = ime_check_string_list(L, 4);
 
-  /* TODO: register_trigger with candidate_trigger_strings. */
-  num = lua_objlen(L, 4);
-  for ( i = 0; i < num; ++i) {
-    lua_pushinteger(L, i + 1);
-    lua_gettable(L, 4);
-    fprintf(stderr, "%d:%s\t", (int) i + 1, lua_tostring(L, -1));
-  }
-  fprintf(stderr, "\n");
+  result = ibus_engine_plugin_add_trigger
+    (lua_plugin_retrieve_plugin(L), &new_trigger);
+
+  g_strfreev(new_trigger.input_trigger_strings);
+  g_strfreev(new_trigger.candidate_trigger_strings);
+
+  if (!result)
+    return luaL_error(L, "register trigger with function %s failed.\n", new_trigger.lua_function_name);
 
   return 0;
 }
 
 static int ime_register_converter(lua_State * L){
-    const char * lua_function_name = luaL_checklstring(L, 1, NULL);
-    const char * description = luaL_checklstring(L, 2, NULL);
+  lua_converter_t new_converter;
+  gboolean result;
 
-    fprintf(stderr, "TODO: ime_register_converter unimplemented when called with %s(%s).\n", lua_function_name, description);
+  memset(&new_converter, 0, sizeof(new_converter));
+  new_converter.lua_function_name = luaL_checklstring(L, 1, NULL);
+  lua_getglobal(L, new_converter.lua_function_name);
+  luaL_checktype(L, -1, LUA_TFUNCTION);
+  lua_pop(L, 1);
+
+  new_converter.description = luaL_checklstring(L, 2, NULL);
+
+  result = ibus_engine_plugin_add_converter
+    (lua_plugin_retrieve_plugin(L), &new_converter);
 
-    return 0;
+  if (!result)
+    return luaL_error(L, "register converter with function %s failed.\n", new_converter.lua_function_name);
+
+  return 0;
 }
 
 static int ime_split_string(lua_State * L){
@@ -411,9 +446,7 @@ static const luaL_Reg imelib[] = {
   {"join_string", ime_join_string},
   {"parse_mapping", ime_parse_mapping},
   {"register_command", ime_register_command},
-  /* Note: the register_converter function is dropped for ibus-libpinyin. */
   {"register_converter", ime_register_converter},
-  /* Note: the register_trigger function is dropped for ibus-libpinyin. */
   {"register_trigger", ime_register_trigger},
   {"split_string", ime_split_string},
   {"trim_string_left", ime_trim_string_left},
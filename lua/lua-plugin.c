@@ -22,6 +22,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <glib/gstdio.h>
 
 #include "lua-plugin.h"
 
@@ -36,9 +37,47 @@
 
 #define IBUS_ENGINE_PLUGIN_GET_PRIVATE(obj) (G_TYPE_INSTANCE_GET_PRIVATE ((obj), IBUS_TYPE_ENGINE_PLUGIN, IBusEnginePluginPrivate))
 
+/* Aho-Corasick automaton state over ascii input trigger strings. */
+#define TRIGGER_ALPHABET_SIZE 128
+
+typedef struct _trigger_state_t{
+  gint next[TRIGGER_ALPHABET_SIZE];
+  gint fail;
+  gint output; /* index into lua_triggers, or -1. */
+  gint output_link; /* nearest state with output in the fail chain, or -1. */
+} trigger_state_t;
+
+/* Max lua instructions for a converter call on a batch of texts. */
+#define LUA_CONVERTER_INSTRUCTION_BUDGET 1000000
+/* Skip a converter after so many overruns, until the scripts are reloaded. */
+#define LUA_CONVERTER_MAX_OVERRUNS 3
+/* Max entries of the result cache for each converter. */
+#define LUA_CONVERTER_CACHE_SIZE 1024
+/* Check the call timeout every such lua instructions. */
+#define LUA_CALL_TIMEOUT_CHECK_COUNT 1000
+/* Default call timeout in milliseconds. */
+#define LUA_CALL_DEFAULT_TIMEOUT 500
+
 struct _IBusEnginePluginPrivate{
   lua_State * L;
-  GArray * lua_commands; /* Array of lua_command_t. */
+  GArray * lua_commands; /* Array of lua_command_t, sorted lazily. */
+  gboolean lua_commands_dirty;
+  GHashTable * command_names; /* set of registered command names. */
+  guint command_index[257]; /* commands starting with byte c are in [c], [c + 1]). */
+  GArray * lua_triggers; /* Array of lua_trigger_t. */
+  GArray * trigger_states; /* Array of trigger_state_t, built lazily. */
+  gboolean trigger_states_dirty;
+  GHashTable * candidate_triggers; /* candidate string => trigger index + 1. */
+  GArray * lua_converters; /* Array of lua_converter_t. */
+  GPtrArray * converter_caches; /* GHashTable of input => output for each converter. */
+  GArray * converter_overruns; /* guint budget overruns of each converter. */
+  gboolean converter_over_budget;
+
+  guint call_timeout; /* in milliseconds, 0 for unlimited. */
+  gint64 call_deadline; /* monotonic time in microseconds. */
+  gboolean call_timed_out;
+  guint call_count;
+  guint call_timeout_count;
 };
 
 G_DEFINE_TYPE (IBusEnginePlugin, ibus_engine_plugin, G_TYPE_OBJECT);
@@ -49,6 +88,7 @@ static void lua_command_clone(lua_command_t * command, lua_command_t * new_comma
   new_command->description = g_strdup(command->description);
   new_command->leading = g_strdup(command->leading);
   new_command->help = g_strdup(command->help);
+  new_command->pure = command->pure;
 }
 
 static void lua_command_reclaim(lua_command_t * command){
@@ -59,6 +99,30 @@ static void lua_command_reclaim(lua_command_t * command){
   g_free((gpointer)command->help);
 }
 
+static void lua_trigger_clone(lua_trigger_t * trigger, lua_trigger_t * new_trigger){
+  new_trigger->lua_function_name = g_strdup(trigger->lua_function_name);
+  new_trigger->description = g_strdup(trigger->description);
+  new_trigger->input_trigger_strings = g_strdupv(trigger->input_trigger_strings);
+  new_trigger->candidate_trigger_strings = g_strdupv(trigger->candidate_trigger_strings);
+}
+
+static void lua_trigger_reclaim(lua_trigger_t * trigger){
+  g_free((gpointer)trigger->lua_function_name);
+  g_free((gpointer)trigger->description);
+  g_strfreev(trigger->input_trigger_strings);
+  g_strfreev(trigger->candidate_trigger_strings);
+}
+
+static void lua_converter_clone(lua_converter_t * converter, lua_converter_t * new_converter){
+  new_converter->lua_function_name = g_strdup(converter->lua_function_name);
+  new_converter->description = g_strdup(converter->description);
+}
+
+static void lua_converter_reclaim(lua_converter_t * converter){
+  g_free((gpointer)converter->lua_function_name);
+  g_free((gpointer)converter->description);
+}
+
 static int
 lua_plugin_init(IBusEnginePluginPrivate * plugin){
   g_assert(NULL == plugin->L);
@@ -70,6 +134,19 @@ lua_plugin_init(IBusEnginePluginPrivate * plugin){
 
   g_assert ( NULL == plugin->lua_commands );
   plugin->lua_commands = g_array_new(TRUE, TRUE, sizeof(lua_command_t));
+  plugin->lua_commands_dirty = FALSE;
+  plugin->command_names = g_hash_table_new(g_str_hash, g_str_equal);
+
+  plugin->lua_triggers = g_array_new(TRUE, TRUE, sizeof(lua_trigger_t));
+  plugin->trigger_states = g_array_new(FALSE, FALSE, sizeof(trigger_state_t));
+  plugin->trigger_states_dirty = FALSE;
+  plugin->candidate_triggers = g_hash_table_new(g_str_hash, g_str_equal);
+
+  plugin->lua_converters = g_array_new(TRUE, TRUE, sizeof(lua_converter_t));
+  plugin->converter_caches = g_ptr_array_new_with_free_func((GDestroyNotify)g_hash_table_destroy);
+  plugin->converter_overruns = g_array_new(FALSE, TRUE, sizeof(guint));
+
+  plugin->call_timeout = LUA_CALL_DEFAULT_TIMEOUT;
   return 0;
 }
 
@@ -77,6 +154,13 @@ static int
 lua_plugin_fini(IBusEnginePluginPrivate * plugin){
   size_t i;
   lua_command_t * command;
+  lua_trigger_t * trigger;
+  lua_converter_t * converter;
+
+  if ( plugin->command_names ){
+    g_hash_table_destroy(plugin->command_names);
+    plugin->command_names = NULL;
+  }
 
   if ( plugin->lua_commands ){
     for ( i = 0; i < plugin->lua_commands->len; ++i){
@@ -87,6 +171,44 @@ lua_plugin_fini(IBusEnginePluginPrivate * plugin){
     plugin->lua_commands = NULL;
   }
 
+  if ( plugin->candidate_triggers ){
+    g_hash_table_destroy(plugin->candidate_triggers);
+    plugin->candidate_triggers = NULL;
+  }
+
+  if ( plugin->trigger_states ){
+    g_array_free(plugin->trigger_states, TRUE);
+    plugin->trigger_states = NULL;
+  }
+
+  if ( plugin->lua_triggers ){
+    for ( i = 0; i < plugin->lua_triggers->len; ++i){
+      trigger = &g_array_index(plugin->lua_triggers, lua_trigger_t, i);
+      lua_trigger_reclaim(trigger);
+    }
+    g_array_free(plugin->lua_triggers, TRUE);
+    plugin->lua_triggers = NULL;
+  }
+
+  if ( plugin->converter_caches ){
+    g_ptr_array_free(plugin->converter_caches, TRUE);
+    plugin->converter_caches = NULL;
+  }
+
+  if ( plugin->converter_overruns ){
+    g_array_free(plugin->converter_overruns, TRUE);
+    plugin->converter_overruns = NULL;
+  }
+
+  if ( plugin->lua_converters ){
+    for ( i = 0; i < plugin->lua_converters->len; ++i){
+      converter = &g_array_index(plugin->lua_converters, lua_converter_t, i);
+      lua_converter_reclaim(converter);
+    }
+    g_array_free(plugin->lua_converters, TRUE);
+    plugin->lua_converters = NULL;
+  }
+
   lua_close(plugin->L);
   plugin->L = NULL;
   return 0;
@@ -153,9 +275,134 @@ static int report (lua_State *L, int status) {
   return status;
 }
 
+static int lua_plugin_dump_writer(lua_State * L, const void * p, size_t sz, void * ud){
+  return fwrite(p, 1, sz, (FILE *)ud) != sz;
+}
+
+/**
+ * get the bytecode cache file for the lua script, named by the checksum
+ * of the script path, then the checksum of the script content and lua
+ * version, so an edit in place never hits a stale chunk.
+ */
+static gchar * lua_plugin_get_bytecode_cache_path(const char * filename,
+                                                  const gchar * contents,
+                                                  gsize length){
+  GChecksum * checksum;
+  gchar * script, * name, * path;
+
+  script = g_compute_checksum_for_string(G_CHECKSUM_SHA1, filename, -1);
+
+  checksum = g_checksum_new(G_CHECKSUM_SHA1);
+  g_checksum_update(checksum, (const guchar *) contents, length);
+  g_checksum_update(checksum, (const guchar *) LUA_RELEASE, -1);
+  name = g_strdup_printf("%s-%s.luac", script, g_checksum_get_string(checksum));
+  path = g_build_filename(g_get_user_cache_dir(),
+                          "ibus", "libpinyin", "lua", name, NULL);
+
+  g_free(name);
+  g_checksum_free(checksum);
+  g_free(script);
+  return path;
+}
+
+/* remove the older cache files of the same script. */
+static void lua_plugin_remove_stale_bytecode(const char * cache_path){
+  gchar * dirname = g_path_get_dirname(cache_path);
+  gchar * basename = g_path_get_basename(cache_path);
+  /* the script part of the name ends with '-'. */
+  gsize prefix_len = strchr(basename, '-') - basename + 1;
+  GDir * dir = g_dir_open(dirname, 0, NULL);
+  const gchar * name;
+  gchar * stale;
+
+  if ( dir ){
+    while ( (name = g_dir_read_name(dir)) != NULL ){
+      if ( strncmp(name, basename, prefix_len) || !strcmp(name, basename) )
+        continue;
+      stale = g_build_filename(dirname, name, NULL);
+      g_unlink(stale);
+      g_free(stale);
+    }
+    g_dir_close(dir);
+  }
+
+  g_free(basename);
+  g_free(dirname);
+}
+
+/* dump the loaded chunk on the top of stack into the cache file. */
+static void lua_plugin_save_bytecode(lua_State * L, const char * cache_path){
+  gchar * dirname = g_path_get_dirname(cache_path);
+  gchar * tmp_path = g_strconcat(cache_path, ".tmp", NULL);
+  FILE * output;
+  int status;
+
+  g_mkdir_with_parents(dirname, 0700);
+  output = fopen(tmp_path, "wb");
+  if ( output ){
+#if LUA_VERSION_NUM >= 503
+    status = lua_dump(L, lua_plugin_dump_writer, output, 0);
+#else
+    status = lua_dump(L, lua_plugin_dump_writer, output);
+#endif
+    if ( fclose(output) )
+      status = 1;
+    if ( status || g_rename(tmp_path, cache_path) )
+      g_unlink(tmp_path);
+    else
+      lua_plugin_remove_stale_bytecode(cache_path);
+  }
+
+  g_free(tmp_path);
+  g_free(dirname);
+}
+
+static int lua_plugin_load_file(lua_State * L, const char * filename, gboolean * cached){
+  gchar * contents = NULL, * cache_path, * chunkname;
+  gsize length = 0;
+  int status;
+
+  *cached = FALSE;
+  /* hash and parse the same bytes, the script may change meanwhile. */
+  if ( !g_file_get_contents(filename, &contents, &length, NULL) )
+    return luaL_loadfile(L, filename);
+
+  cache_path = lua_plugin_get_bytecode_cache_path(filename, contents, length);
+  if ( g_file_test(cache_path, G_FILE_TEST_IS_REGULAR) ){
+    status = luaL_loadfile(L, cache_path);
+    if ( 0 == status ){
+      *cached = TRUE;
+      g_free(cache_path);
+      g_free(contents);
+      return status;
+    }
+    /* broken cache, parse the script again. */
+    lua_pop(L, 1);
+  }
+
+  chunkname = g_strconcat("@", filename, NULL);
+  status = luaL_loadbuffer(L, contents, length, chunkname);
+  if ( 0 == status )
+    lua_plugin_save_bytecode(L, cache_path);
+
+  g_free(chunkname);
+  g_free(cache_path);
+  g_free(contents);
+  return status;
+}
+
 int ibus_engine_plugin_load_lua_script(IBusEnginePlugin * plugin, const char * filename){
   IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
-  int status = luaL_dofile(priv->L, filename);
+  gint64 start = g_get_monotonic_time();
+  gboolean cached = FALSE;
+
+  int status = lua_plugin_load_file(priv->L, filename, &cached);
+  if ( 0 == status )
+    status = lua_pcall(priv->L, 0, LUA_MULTRET, 0);
+
+  g_debug("load lua script %s in %" G_GINT64_FORMAT " us (%s).", filename,
+          g_get_monotonic_time() - start,
+          cached ? "bytecode cache" : "source");
   return report(priv->L, status);
 }
 
@@ -166,37 +413,434 @@ static gint compare_command(gconstpointer a, gconstpointer b){
   return strcmp(ca->command_name, cb->command_name);
 }
 
+/* sort the commands registered since last lookup, and rebuild the prefix index. */
+static void lua_plugin_sort_commands(IBusEnginePluginPrivate * priv){
+  GArray * lua_commands = priv->lua_commands;
+  guint i; int c = 0;
+
+  if ( !priv->lua_commands_dirty )
+    return;
+
+  g_array_sort(lua_commands, compare_command);
+
+  for ( i = 0; i < lua_commands->len; ++i){
+    lua_command_t * command = &g_array_index(lua_commands, lua_command_t, i);
+    int first = (guchar) command->command_name[0];
+    for ( ; c <= first; ++c)
+      priv->command_index[c] = i;
+  }
+  for ( ; c <= 256; ++c)
+    priv->command_index[c] = lua_commands->len;
+
+  priv->lua_commands_dirty = FALSE;
+}
+
 gboolean ibus_engine_plugin_add_command(IBusEnginePlugin * plugin, lua_command_t * command){
   IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
   GArray * lua_commands = priv->lua_commands;
 
-  if ( ibus_engine_plugin_lookup_command( plugin, command->command_name) )
+  if ( g_hash_table_lookup(priv->command_names, command->command_name) )
     return FALSE;
 
   lua_command_t new_command;
   lua_command_clone(command, &new_command);
 
+  /* sort once after all commands are loaded. */
   g_array_append_val(lua_commands, new_command);
-  /* Note: need to improve speed here? */
-  g_array_sort(lua_commands, compare_command);
+  g_hash_table_insert(priv->command_names, (gpointer)new_command.command_name, GINT_TO_POINTER(TRUE));
+  priv->lua_commands_dirty = TRUE;
 
   return TRUE;
 }
 
+const lua_command_t * ibus_engine_plugin_get_commands_with_prefix(IBusEnginePlugin * plugin, const char * prefix, guint * num){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  GArray * lua_commands = priv->lua_commands;
+  const lua_command_t * command;
+  guint begin, end;
+
+  lua_plugin_sort_commands(priv);
+
+  *num = 0;
+  if ( NULL == prefix || '\0' == prefix[0] ){
+    *num = lua_commands->len;
+    return (const lua_command_t *) lua_commands->data;
+  }
+
+  if ( '\0' != prefix[1] ){
+    command = ibus_engine_plugin_lookup_command(plugin, prefix);
+    if ( command )
+      *num = 1;
+    return command;
+  }
+
+  begin = priv->command_index[(guchar) prefix[0]];
+  end = priv->command_index[(guchar) prefix[0] + 1];
+  *num = end - begin;
+  return &g_array_index(lua_commands, lua_command_t, begin);
+}
+
 const lua_command_t * ibus_engine_plugin_lookup_command(IBusEnginePlugin * plugin, const char * command_name){
   IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
   GArray * lua_commands = priv->lua_commands;
   lua_command_t lookup_command = {.command_name = command_name, };
 
+  lua_plugin_sort_commands(priv);
+
   lua_command_t * result = bsearch(&lookup_command, lua_commands->data, lua_commands->len, sizeof(lua_command_t), compare_command);
   return result;
 }
 
 const GArray * ibus_engine_plugin_get_available_commands(IBusEnginePlugin * plugin){
   IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  lua_plugin_sort_commands(priv);
   return priv->lua_commands;
 }
 
+static gboolean trigger_string_is_valid(const char * str){
+  const char * p;
+
+  if ( NULL == str || '\0' == str[0] )
+    return FALSE;
+
+  for ( p = str; *p; ++p){
+    if ( (guchar)*p >= TRIGGER_ALPHABET_SIZE )
+      return FALSE;
+  }
+  return TRUE;
+}
+
+gboolean ibus_engine_plugin_add_trigger(IBusEnginePlugin * plugin, lua_trigger_t * trigger){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  GArray * lua_triggers = priv->lua_triggers;
+  gchar ** strings;
+  lua_trigger_t * new_trigger;
+
+  for ( strings = trigger->input_trigger_strings; strings && *strings; ++strings){
+    if ( !trigger_string_is_valid(*strings) )
+      return FALSE;
+  }
+
+  lua_trigger_t tmp;
+  lua_trigger_clone(trigger, &tmp);
+  g_array_append_val(lua_triggers, tmp);
+  new_trigger = &g_array_index(lua_triggers, lua_trigger_t, lua_triggers->len - 1);
+
+  /* the earlier registered trigger wins for the same candidate string. */
+  for ( strings = new_trigger->candidate_trigger_strings; strings && *strings; ++strings){
+    if ( !g_hash_table_lookup(priv->candidate_triggers, *strings) )
+      g_hash_table_insert(priv->candidate_triggers, *strings,
+                          GINT_TO_POINTER(lua_triggers->len));
+  }
+
+  /* rebuild the matcher on next match. */
+  priv->trigger_states_dirty = TRUE;
+  return TRUE;
+}
+
+const GArray * ibus_engine_plugin_get_available_triggers(IBusEnginePlugin * plugin){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  return priv->lua_triggers;
+}
+
+static gint trigger_state_new(GArray * states){
+  trigger_state_t state;
+  int c;
+
+  for ( c = 0; c < TRIGGER_ALPHABET_SIZE; ++c)
+    state.next[c] = -1;
+  state.fail = 0;
+  state.output = -1;
+  state.output_link = -1;
+  g_array_append_val(states, state);
+  return states->len - 1;
+}
+
+/* build the Aho-Corasick automaton, with full transitions for each state. */
+static void lua_plugin_build_trigger_states(IBusEnginePluginPrivate * priv){
+  GArray * states = priv->trigger_states;
+  trigger_state_t * state, * child;
+  gint * queue; guint head = 0, tail = 0;
+  gint cur, next; guint i; int c;
+  const char * p; gchar ** strings;
+
+  g_array_set_size(states, 0);
+  trigger_state_new(states);
+
+  /* build the trie. */
+  for ( i = 0; i < priv->lua_triggers->len; ++i){
+    lua_trigger_t * trigger = &g_array_index(priv->lua_triggers, lua_trigger_t, i);
+    for ( strings = trigger->input_trigger_strings; strings && *strings; ++strings){
+      cur = 0;
+      for ( p = *strings; *p; ++p){
+        c = (guchar)*p;
+        next = g_array_index(states, trigger_state_t, cur).next[c];
+        if ( -1 == next ){
+          next = trigger_state_new(states);
+          g_array_index(states, trigger_state_t, cur).next[c] = next;
+        }
+        cur = next;
+      }
+      state = &g_array_index(states, trigger_state_t, cur);
+      if ( -1 == state->output )
+        state->output = i;
+    }
+  }
+
+  /* compute fail links and transitions in breadth first order. */
+  queue = g_new(gint, states->len);
+  state = &g_array_index(states, trigger_state_t, 0);
+  for ( c = 0; c < TRIGGER_ALPHABET_SIZE; ++c){
+    next = state->next[c];
+    if ( -1 == next ){
+      state->next[c] = 0;
+    } else {
+      g_array_index(states, trigger_state_t, next).fail = 0;
+      queue[tail++] = next;
+    }
+  }
+
+  while ( head < tail ){
+    cur = queue[head++];
+    state = &g_array_index(states, trigger_state_t, cur);
+    for ( c = 0; c < TRIGGER_ALPHABET_SIZE; ++c){
+      trigger_state_t * fail = &g_array_index(states, trigger_state_t, state->fail);
+      next = state->next[c];
+      if ( -1 == next ){
+        state->next[c] = fail->next[c];
+        continue;
+      }
+      child = &g_array_index(states, trigger_state_t, next);
+      child->fail = fail->next[c];
+      fail = &g_array_index(states, trigger_state_t, child->fail);
+      child->output_link = -1 != fail->output ? child->fail : fail->output_link;
+      queue[tail++] = next;
+    }
+  }
+  g_free(queue);
+
+  priv->trigger_states_dirty = FALSE;
+}
+
+GArray * ibus_engine_plugin_match_input_triggers(IBusEnginePlugin * plugin, const char * input){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  GArray * result = NULL;
+  const trigger_state_t * states;
+  const lua_trigger_t * trigger;
+  const char * p; gint cur = 0, s; guint i; int c;
+
+  if ( 0 == priv->lua_triggers->len || NULL == input )
+    return result;
+
+  if ( priv->trigger_states_dirty )
+    lua_plugin_build_trigger_states(priv);
+
+  states = (const trigger_state_t *) priv->trigger_states->data;
+  for ( p = input; *p; ++p){
+    c = (guchar)*p;
+    if ( c >= TRIGGER_ALPHABET_SIZE ){
+      cur = 0;
+      continue;
+    }
+    cur = states[cur].next[c];
+
+    s = -1 != states[cur].output ? cur : states[cur].output_link;
+    for ( ; -1 != s; s = states[s].output_link){
+      trigger = &g_array_index(priv->lua_triggers, lua_trigger_t, states[s].output);
+      if ( NULL == result )
+        result = g_array_new(TRUE, TRUE, sizeof(const lua_trigger_t *));
+      for ( i = 0; i < result->len; ++i){
+        if ( trigger == g_array_index(result, const lua_trigger_t *, i) )
+          break;
+      }
+      if ( i == result->len )
+        g_array_append_val(result, trigger);
+    }
+  }
+
+  return result;
+}
+
+const lua_trigger_t * ibus_engine_plugin_match_candidate_trigger(IBusEnginePlugin * plugin, const char * candidate){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  gint index;
+
+  if ( NULL == candidate )
+    return NULL;
+
+  index = GPOINTER_TO_INT(g_hash_table_lookup(priv->candidate_triggers, candidate));
+  if ( 0 == index )
+    return NULL;
+  return &g_array_index(priv->lua_triggers, lua_trigger_t, index - 1);
+}
+
+gboolean ibus_engine_plugin_add_converter(IBusEnginePlugin * plugin, lua_converter_t * converter){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  GHashTable * cache;
+  guint overruns = 0;
+
+  lua_converter_t new_converter;
+  lua_converter_clone(converter, &new_converter);
+  g_array_append_val(priv->lua_converters, new_converter);
+
+  cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+  g_ptr_array_add(priv->converter_caches, cache);
+  g_array_append_val(priv->converter_overruns, overruns);
+  return TRUE;
+}
+
+const GArray * ibus_engine_plugin_get_available_converters(IBusEnginePlugin * plugin){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  return priv->lua_converters;
+}
+
+static void lua_plugin_budget_hook(lua_State * L, lua_Debug * ar){
+  IBusEnginePlugin * plugin = lua_plugin_retrieve_plugin(L);
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+
+  priv->converter_over_budget = TRUE;
+  luaL_error(L, "instruction budget exceeded.");
+}
+
+/**
+ * convert a table of strings (arg 1) with the lua function named arg 2,
+ * return a table of converted strings.
+ */
+static int lua_plugin_convert_batch(lua_State * L){
+  const char * lua_function_name = luaL_checklstring(L, 2, NULL);
+  int num = lua_objlen(L, 1); int i;
+
+  lua_createtable(L, num, 0);
+  for ( i = 1; i <= num; ++i){
+    lua_getglobal(L, lua_function_name);
+    lua_rawgeti(L, 1, i);
+    lua_call(L, 1, 1);
+    /* pass through the non-string results. */
+    if ( !lua_isstring(L, -1) ){
+      lua_pop(L, 1);
+      lua_rawgeti(L, 1, i);
+    }
+    lua_rawseti(L, 3, i);
+  }
+  return 1;
+}
+
+void ibus_engine_plugin_convert(IBusEnginePlugin * plugin, gchar ** texts){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  lua_State * L = priv->L;
+  GArray * indexes;
+  GHashTable * cache;
+  const char * cached;
+  guint i, k, num;
+  int status;
+
+  if ( 0 == priv->lua_converters->len )
+    return;
+
+  indexes = g_array_new(FALSE, FALSE, sizeof(guint));
+
+  for ( k = 0; k < priv->lua_converters->len; ++k){
+    lua_converter_t * converter = &g_array_index(priv->lua_converters, lua_converter_t, k);
+    guint * overruns = &g_array_index(priv->converter_overruns, guint, k);
+    cache = g_ptr_array_index(priv->converter_caches, k);
+
+    /* a converter too slow for every batch passes through. */
+    if ( *overruns >= LUA_CONVERTER_MAX_OVERRUNS )
+      continue;
+
+    /* only pass the texts missed in cache to lua. */
+    g_array_set_size(indexes, 0);
+    lua_pushcfunction(L, lua_plugin_convert_batch);
+    lua_newtable(L);
+    for ( i = 0; texts[i]; ++i){
+      cached = g_hash_table_lookup(cache, texts[i]);
+      if ( cached ){
+        g_free(texts[i]);
+        texts[i] = g_strdup(cached);
+        continue;
+      }
+      g_array_append_val(indexes, i);
+      lua_pushstring(L, texts[i]);
+      lua_rawseti(L, -2, indexes->len);
+    }
+
+    num = indexes->len;
+    if ( 0 == num ){
+      lua_pop(L, 2);
+      continue;
+    }
+
+    lua_pushstring(L, converter->lua_function_name);
+
+    /* a slow converter falls back to pass through. */
+    priv->converter_over_budget = FALSE;
+    lua_sethook(L, lua_plugin_budget_hook, LUA_MASKCOUNT, LUA_CONVERTER_INSTRUCTION_BUDGET);
+    status = lua_pcall(L, 2, 1, 0);
+    lua_sethook(L, NULL, 0, 0);
+
+    if ( g_hash_table_size(cache) + num > LUA_CONVERTER_CACHE_SIZE )
+      g_hash_table_remove_all(cache);
+
+    if ( status ){
+      report(L, status);
+      if ( priv->converter_over_budget )
+        ++*overruns;
+      /* cache the texts of the failed batch as passed through. */
+      for ( i = 0; i < num; ++i){
+        guint index = g_array_index(indexes, guint, i);
+        g_hash_table_insert(cache, g_strdup(texts[index]), g_strdup(texts[index]));
+      }
+      continue;
+    }
+
+    for ( i = 0; i < num; ++i){
+      guint index = g_array_index(indexes, guint, i);
+      lua_rawgeti(L, -1, i + 1);
+      gchar * result = g_strdup(lua_tostring(L, -1));
+      lua_pop(L, 1);
+
+      g_hash_table_insert(cache, texts[index], g_strdup(result));
+      texts[index] = result;
+    }
+    lua_pop(L, 1);
+  }
+
+  g_array_free(indexes, TRUE);
+}
+
+void ibus_engine_plugin_set_call_timeout(IBusEnginePlugin * plugin, guint timeout){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  priv->call_timeout = timeout;
+}
+
+void ibus_engine_plugin_get_call_stats(IBusEnginePlugin * plugin, guint * calls, guint * timeouts){
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+  if (calls) *calls = priv->call_count;
+  if (timeouts) *timeouts = priv->call_timeout_count;
+}
+
+static void lua_plugin_timeout_hook(lua_State * L, lua_Debug * ar){
+  IBusEnginePlugin * plugin = lua_plugin_retrieve_plugin(L);
+  IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
+
+  if ( g_get_monotonic_time() < priv->call_deadline )
+    return;
+
+  priv->call_timed_out = TRUE;
+  luaL_error(L, "call timed out.");
+}
+
+/* push the "timed out" candidate as the call result. */
+static void lua_plugin_push_timed_out(lua_State * L){
+  lua_createtable(L, 1, 0);
+  lua_createtable(L, 0, 2);
+  lua_pushliteral(L, "");
+  lua_setfield(L, -2, "suggest");
+  lua_pushliteral(L, "timed out");
+  lua_setfield(L, -2, "help");
+  lua_rawseti(L, -2, 1);
+}
+
 int ibus_engine_plugin_call(IBusEnginePlugin * plugin, const char * lua_function_name, const char * argument /*optional, maybe NULL.*/){
   IBusEnginePluginPrivate * priv = IBUS_ENGINE_PLUGIN_GET_PRIVATE(plugin);
   int type; int result;
@@ -210,20 +854,45 @@ int ibus_engine_plugin_call(IBusEnginePlugin * plugin, const char * lua_function
   /* check whether lua_function_name exists. */
   lua_getglobal(L, lua_function_name);
   type = lua_type(L, -1);
-  if ( LUA_TFUNCTION != type )
+  if ( LUA_TFUNCTION != type ){
+    lua_pop(L, 1);
     return 0;
+  }
   lua_pushstring(L, argument);
 
+  priv->call_count++;
+  priv->call_timed_out = FALSE;
+  if ( priv->call_timeout ){
+    priv->call_deadline = g_get_monotonic_time() +
+      (gint64) priv->call_timeout * 1000;
+    lua_sethook(L, lua_plugin_timeout_hook, LUA_MASKCOUNT, LUA_CALL_TIMEOUT_CHECK_COUNT);
+  }
   result = lua_pcall(L, 1, 1, 0);
-  if (result) return 0;
+  if ( priv->call_timeout )
+    lua_sethook(L, NULL, 0, 0);
+
+  if (result){
+    report(L, result);
+    if ( priv->call_timed_out ){
+      priv->call_timeout_count++;
+      g_warning("lua function %s timed out.", lua_function_name);
+      lua_plugin_push_timed_out(L);
+      return 1;
+    }
+    return 0;
+  }
 
   type = lua_type(L, -1);
   if ( LUA_TTABLE == type ){
-    return lua_objlen(L, -1);
+    result = lua_objlen(L, -1);
+    if ( 0 == result )
+      lua_pop(L, 1);
+    return result;
   } else if (LUA_TNUMBER == type || LUA_TBOOLEAN == type || LUA_TSTRING == type){
     return 1;
   }
 
+  lua_pop(L, 1);
   return 0;
 }
 
@@ -315,4 +984,5 @@ void ibus_engine_plugin_free_candidate(lua_command_candidate_t * candidate){
   g_free((gpointer)candidate->content);
   g_free((gpointer)candidate->suggest);
   g_free((gpointer)candidate->help);
+  free(candidate);
 }
@@ -41,6 +41,7 @@ typedef struct _lua_command_t{
   const char * description;
   const char * leading; /* optional, default "digit". */
   const char * help; /* optional. */
+  gboolean pure; /* optional, default FALSE, results only depend on argument. */
 } lua_command_t;
 
 typedef struct _lua_command_candidate_t{
@@ -52,13 +53,15 @@ typedef struct _lua_command_candidate_t{
 typedef struct _lua_trigger_t{
   const char * lua_function_name;
   const char * description;
-  /*< private, skip it, and register it into Special Table directly with * wildcard. >*/
-  /*
-   * list of input_trigger_strings;
-   * list of candidate_trigger_strings;
-   */
+  gchar ** input_trigger_strings; /* NULL-terminated. */
+  gchar ** candidate_trigger_strings; /* NULL-terminated. */
 } lua_trigger_t;
 
+typedef struct _lua_converter_t{
+  const char * lua_function_name;
+  const char * description;
+} lua_converter_t;
+
 /*
  * Type macros.
  */
@@ -76,6 +79,7 @@ typedef struct _IBusEnginePluginPrivate IBusEnginePluginPrivate;
 
 void lua_plugin_openlibs (lua_State *L);
 void lua_plugin_store_plugin(lua_State * L, IBusEnginePlugin * plugin);
+IBusEnginePlugin * lua_plugin_retrieve_plugin(lua_State * L);
 
 struct _IBusEnginePlugin
 {
@@ -113,6 +117,12 @@ gboolean ibus_engine_plugin_add_command(IBusEnginePlugin * plugin, lua_command_t
  */
 const GArray * ibus_engine_plugin_get_available_commands(IBusEnginePlugin * plugin);
 
+/**
+ * retrieve the lua plugin commands starting with prefix.
+ * return the first matched command in the sorted commands, and set num to the number of matches.
+ */
+const lua_command_t * ibus_engine_plugin_get_commands_with_prefix(IBusEnginePlugin * plugin, const char * prefix, guint * num);
+
 /**
  * Lookup a special command in ime lua extension.
  * command must be an 2-char long string.
@@ -120,9 +130,65 @@ const GArray * ibus_engine_plugin_get_available_commands(IBusEnginePlugin * plug
  */
 const lua_command_t * ibus_engine_plugin_lookup_command(IBusEnginePlugin * plugin, const char * command_name);
 
+/**
+ * add a lua_trigger_t to plugin.
+ * input trigger strings must be non-empty ascii strings.
+ */
+gboolean ibus_engine_plugin_add_trigger(IBusEnginePlugin * plugin, lua_trigger_t * trigger);
+
+/**
+ * retrieve all available lua plugin triggers.
+ * return array of trigger informations of type lua_trigger_t without copies.
+ */
+const GArray * ibus_engine_plugin_get_available_triggers(IBusEnginePlugin * plugin);
+
+/**
+ * match all input trigger strings against input in a single pass.
+ * return array of matched triggers (const lua_trigger_t *), or NULL when nothing matched.
+ * the returned array should be freed by g_array_free.
+ */
+GArray * ibus_engine_plugin_match_input_triggers(IBusEnginePlugin * plugin, const char * input);
+
+/**
+ * lookup the trigger registered with the candidate trigger string.
+ * return the matched trigger.
+ */
+const lua_trigger_t * ibus_engine_plugin_match_candidate_trigger(IBusEnginePlugin * plugin, const char * candidate);
+
+/**
+ * add a lua_converter_t to plugin.
+ */
+gboolean ibus_engine_plugin_add_converter(IBusEnginePlugin * plugin, lua_converter_t * converter);
+
+/**
+ * retrieve all available lua plugin converters.
+ * return array of converter informations of type lua_converter_t without copies.
+ */
+const GArray * ibus_engine_plugin_get_available_converters(IBusEnginePlugin * plugin);
+
+/**
+ * run all converters on texts in place, with one lua call for each converter.
+ * texts is a NULL-terminated array of strings allocated by g_malloc,
+ * the replaced strings are freed.
+ * a converter exceeding its instruction budget leaves texts unchanged.
+ */
+void ibus_engine_plugin_convert(IBusEnginePlugin * plugin, gchar ** texts);
+
+/**
+ * set the wall-clock budget of ibus_engine_plugin_call in milliseconds,
+ * 0 means unlimited.
+ */
+void ibus_engine_plugin_set_call_timeout(IBusEnginePlugin * plugin, guint timeout);
+
+/**
+ * retrieve the number of calls and timed out calls of ibus_engine_plugin_call.
+ */
+void ibus_engine_plugin_get_call_stats(IBusEnginePlugin * plugin, guint * calls, guint * timeouts);
+
 /**
  * retval int: returns the number of results,
  *              only support string or string array.
+ * a call exceeding the timeout is aborted, and returns a "timed out" candidate.
  * the consequence call of ibus_engine_plugin_get_retval* must follow this call immediately.
  */
 int ibus_engine_plugin_call(IBusEnginePlugin * plugin, const char * lua_function_name, const char * argument /*optional, maybe NULL.*/);
@@ -21,6 +21,7 @@
 
 
 #include <stdio.h>
+#include <string.h>
 #include <glib.h>
 
 #include "lua-plugin.h"
@@ -34,6 +35,55 @@ int main(int argc, char * argv[]){
   plugin = ibus_engine_plugin_new();
 
   ibus_engine_plugin_load_lua_script(plugin, LUASCRIPTDIR G_DIR_SEPARATOR_S "test.lua");
+
+  GArray * triggers = ibus_engine_plugin_match_input_triggers(plugin, "xianzaishijian");
+  g_assert(triggers && 1 == triggers->len);
+  g_array_free(triggers, TRUE);
+  g_assert(NULL == ibus_engine_plugin_match_input_triggers(plugin, "nihao"));
+  g_assert(ibus_engine_plugin_match_candidate_trigger(plugin, "时间"));
+
+  gchar * texts[] = { g_strdup("ni"), g_strdup("hao"), NULL };
+  ibus_engine_plugin_convert(plugin, texts);
+  g_assert(0 == strcmp(texts[0], "<ni>") && 0 == strcmp(texts[1], "<hao>"));
+
+  /* the slow converter is stopped, and passes through. */
+  lua_converter_t converter = {"test_slow_converter", "test slow converter"};
+  ibus_engine_plugin_add_converter(plugin, &converter);
+  ibus_engine_plugin_convert(plugin, texts);
+  g_assert(0 == strcmp(texts[0], "<<ni>>") && 0 == strcmp(texts[1], "<<hao>>"));
+  g_free(texts[0]);
+  g_free(texts[1]);
+
+  /* commands are listed by prefix, in sorted order. */
+  guint num = 0;
+  lua_command_t commands[] = {
+    {"tb", "test_slow_command", "b"},
+    {"ta", "test_slow_command", "a"},
+    {"xa", "test_slow_command", "x"},
+  };
+  for (guint i = 0; i < G_N_ELEMENTS(commands); ++i)
+    g_assert(ibus_engine_plugin_add_command(plugin, &commands[i]));
+  g_assert(!ibus_engine_plugin_add_command(plugin, &commands[0]));
+  const lua_command_t * matched =
+    ibus_engine_plugin_get_commands_with_prefix(plugin, "t", &num);
+  g_assert(2 == num && 0 == strcmp(matched[0].command_name, "ta"));
+  ibus_engine_plugin_get_commands_with_prefix(plugin, "tb", &num);
+  g_assert(1 == num);
+  ibus_engine_plugin_get_commands_with_prefix(plugin, "y", &num);
+  g_assert(0 == num);
+  ibus_engine_plugin_get_commands_with_prefix(plugin, "", &num);
+  g_assert(3 == num);
+
+  /* the slow command is aborted, and returns the timed out candidate. */
+  guint timeouts = 0;
+  ibus_engine_plugin_set_call_timeout(plugin, 100);
+  g_assert(1 == ibus_engine_plugin_call(plugin, "test_slow_command", NULL));
+  lua_command_candidate_t * candidate = (lua_command_candidate_t *)
+    ibus_engine_plugin_get_retval(plugin);
+  g_assert(candidate->help && 0 == strcmp(candidate->help, "timed out"));
+  ibus_engine_plugin_free_candidate(candidate);
+  ibus_engine_plugin_get_call_stats(plugin, NULL, &timeouts);
+  g_assert(1 == timeouts);
   
   g_object_unref(plugin);
 
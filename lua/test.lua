@@ -35,4 +35,24 @@ end
 
 -- print(ime.join_string({nil, "  "}, ","));
 
+function test_trigger(input)
+  return "trigger: " .. input
+end
+
+ime.register_trigger("test_trigger", "test trigger", {"shijian", "sj"}, {"时间"})
+
+function test_converter(input)
+  return "<" .. input .. ">"
+end
+
+function test_slow_converter(input)
+  while true do end
+end
+
+ime.register_converter("test_converter", "test converter")
+
+function test_slow_command(input)
+  while true do end
+end
+
 print("test finished...");
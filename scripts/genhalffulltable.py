@@ -0,0 +1,156 @@
+# vim:set et sts=4:
+# -*- coding: utf-8 -*-
+
+import sys
+
+# (half, full, count)
+half_full_ranges = [
+    (0x0020, 0x3000, 1),
+    (0x0021, 0xFF01, 94),
+    (0x00A2, 0xFFE0, 2),
+    (0x00A5, 0xFFE5, 1),
+    (0x00A6, 0xFFE4, 1),
+    (0x00AC, 0xFFE2, 1),
+    (0x00AF, 0xFFE3, 1),
+    (0x20A9, 0xFFE6, 1),
+    (0xFF61, 0x3002, 1),
+    (0xFF62, 0x300C, 2),
+    (0xFF64, 0x3001, 1),
+    (0xFF65, 0x30FB, 1),
+    (0xFF66, 0x30F2, 1),
+    (0xFF67, 0x30A1, 1),
+    (0xFF68, 0x30A3, 1),
+    (0xFF69, 0x30A5, 1),
+    (0xFF6A, 0x30A7, 1),
+    (0xFF6B, 0x30A9, 1),
+    (0xFF6C, 0x30E3, 1),
+    (0xFF6D, 0x30E5, 1),
+    (0xFF6E, 0x30E7, 1),
+    (0xFF6F, 0x30C3, 1),
+    (0xFF70, 0x30FC, 1),
+    (0xFF71, 0x30A2, 1),
+    (0xFF72, 0x30A4, 1),
+    (0xFF73, 0x30A6, 1),
+    (0xFF74, 0x30A8, 1),
+    (0xFF75, 0x30AA, 2),
+    (0xFF77, 0x30AD, 1),
+    (0xFF78, 0x30AF, 1),
+    (0xFF79, 0x30B1, 1),
+    (0xFF7A, 0x30B3, 1),
+    (0xFF7B, 0x30B5, 1),
+    (0xFF7C, 0x30B7, 1),
+    (0xFF7D, 0x30B9, 1),
+    (0xFF7E, 0x30BB, 1),
+    (0xFF7F, 0x30BD, 1),
+    (0xFF80, 0x30BF, 1),
+    (0xFF81, 0x30C1, 1),
+    (0xFF82, 0x30C4, 1),
+    (0xFF83, 0x30C6, 1),
+    (0xFF84, 0x30C8, 1),
+    (0xFF85, 0x30CA, 6),
+    (0xFF8B, 0x30D2, 1),
+    (0xFF8C, 0x30D5, 1),
+    (0xFF8D, 0x30D8, 1),
+    (0xFF8E, 0x30DB, 1),
+    (0xFF8F, 0x30DE, 5),
+    (0xFF94, 0x30E4, 1),
+    (0xFF95, 0x30E6, 1),
+    (0xFF96, 0x30E8, 6),
+    (0xFF9C, 0x30EF, 1),
+    (0xFF9D, 0x30F3, 1),
+    (0xFFA0, 0x3164, 1),
+    (0xFFA1, 0x3131, 30),
+    (0xFFC2, 0x314F, 6),
+    (0xFFCA, 0x3155, 6),
+    (0xFFD2, 0x315B, 9),
+    (0xFFE9, 0x2190, 4),
+    (0xFFED, 0x25A0, 1),
+    (0xFFEE, 0x25CB, 1),
+]
+
+# dense blocks: (name, begin, end)
+half_blocks = [
+    ('half_full_latin1_table', 0x0000, 0x0100),
+    ('half_full_halfwidth_table', 0xFF61, 0xFFEF),
+]
+
+full_blocks = [
+    ('full_half_cjk_table', 0x3000, 0x3190),
+    ('full_half_fullwidth_table', 0xFF00, 0xFFEF),
+]
+
+def pairs():
+    for half, full, count in half_full_ranges:
+        for i in range(count):
+            yield half + i, full + i
+
+def in_blocks(ch, blocks):
+    for name, begin, end in blocks:
+        if begin <= ch < end:
+            return True
+    return False
+
+def utf8(ch):
+    if sys.version_info[0] >= 3:
+        return chr(ch).encode('utf-8')
+    return unichr(ch).encode('utf-8')
+
+def out(line = ''):
+    sys.stdout.write(line + '\n')
+
+def gen_dense(name, begin, end, mapping):
+    out('static const gunichar')
+    out('%s[0x%04X - 0x%04X] = {' % (name, end, begin))
+    for row in range(begin, end, 8):
+        cells = []
+        for ch in range(row, min(row + 8, end)):
+            cells.append('0x%04X' % mapping.get(ch, ch))
+        out('    %s,' % ', '.join(cells))
+    out('};')
+    out()
+
+def gen_rest(name, items):
+    ranges = []
+    for src, dst in sorted(items):
+        if ranges and ranges[-1][0] + ranges[-1][2] == src and \
+           ranges[-1][1] + ranges[-1][2] == dst:
+            ranges[-1][2] += 1
+        else:
+            ranges.append([src, dst, 1])
+    out('static const gunichar')
+    out('%s[][3] = {' % name)
+    for src, dst, count in ranges:
+        out('    { 0x%04X, 0x%04X, %d },' % (src, dst, count))
+    out('};')
+    out()
+
+def gen_ascii_utf8(to_full):
+    out('/* utf8 encoding of the full width form of printable ascii 0x20 - 0x7E */')
+    out('static const gchar')
+    out('half_full_ascii_utf8[0x7F - 0x20][4] = {')
+    for ch in range(0x20, 0x7F):
+        s = ''.join(['\\x%02X' % c for c in bytearray(utf8(to_full[ch]))])
+        out('    "%s",    // 0x%02X' % (s, ch))
+    out('};')
+    out()
+
+def gen_table():
+    to_full = dict(pairs())
+    to_half = dict([(full, half) for half, full in pairs()])
+
+    out('/* This file is generated by scripts/genhalffulltable.py */')
+    out()
+    for name, begin, end in half_blocks:
+        gen_dense(name, begin, end, to_full)
+    gen_rest('half_full_rest_table',
+        [(h, f) for h, f in to_full.items() if not in_blocks(h, half_blocks)])
+
+    for name, begin, end in full_blocks:
+        gen_dense(name, begin, end, to_half)
+    gen_rest('full_half_rest_table',
+        [(f, h) for f, h in to_half.items() if not in_blocks(f, full_blocks)])
+
+    gen_ascii_utf8(to_full)
+
+if __name__ == "__main__":
+    gen_table()
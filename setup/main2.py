@@ -371,12 +371,17 @@ class PreferencesDialog:
 
         self.__export_dictionary = self.__builder.get_object("ExportDictionary")
         self.__export_dictionary.connect("clicked", self.__export_dictionary_cb)
+        self.__export_dictionary_label = self.__export_dictionary.get_label()
 
         self.__clear_user_data = self.__builder.get_object("ClearUserData")
         self.__clear_user_data.connect("clicked", self.__clear_user_data_cb, "user")
         self.__clear_all_data = self.__builder.get_object("ClearAllData")
         self.__clear_all_data.connect("clicked", self.__clear_user_data_cb, "all")
 
+        # the engine writes the exported phrase count while exporting,
+        # and the export result when the file is written
+        self.__config.connect("value-changed", self.__config_value_changed_cb)
+
     def __edit_lua_cb(self, widget):
         import shutil
         path = os.path.join(GLib.get_user_config_dir(), "ibus", "libpinyin")
@@ -420,10 +425,43 @@ class PreferencesDialog:
 
         response = dialog.run()
         if response == Gtk.ResponseType.OK:
+            # a result equal to the last one would not be notified
+            self.__config.unset(self.__config_namespace, "ExportDictionaryResult")
             self.__set_value("ExportDictionary", dialog.get_filename())
 
         dialog.destroy()
 
+    def __config_value_changed_cb(self, config, section, name, value):
+        if section.lower() != self.__config_namespace.lower():
+            return
+        if name != "ExportDictionaryResult":
+            return
+        # the result is unset before each export
+        if value.get_type_string() == "u":
+            self.__export_dictionary.set_sensitive(False)
+            self.__export_dictionary.set_label(
+                _("Exported %d phrases") % value.unpack())
+            return
+        if value.get_type_string() != "s":
+            return
+
+        self.__export_dictionary.set_sensitive(True)
+        self.__export_dictionary.set_label(self.__export_dictionary_label)
+        message = value.unpack()
+        if message:
+            dialog = Gtk.MessageDialog(self.__dialog, Gtk.DialogFlags.MODAL,
+                                       Gtk.MessageType.ERROR,
+                                       Gtk.ButtonsType.CLOSE,
+                                       _("Export dictionary failed"))
+            dialog.format_secondary_text(message)
+        else:
+            dialog = Gtk.MessageDialog(self.__dialog, Gtk.DialogFlags.MODAL,
+                                       Gtk.MessageType.INFO,
+                                       Gtk.ButtonsType.CLOSE,
+                                       _("Export dictionary finished"))
+        dialog.run()
+        dialog.destroy()
+
     def __clear_user_data_cb(self, widget, name):
         self.__set_value("ClearUserData", name)
 
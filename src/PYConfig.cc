@@ -20,25 +20,40 @@
  */
 #include "PYConfig.h"
 
+#include <set>
+
 #include "PYTypes.h"
 #include "PYBus.h"
 
 namespace PY {
 
+/* bump the number when the format of the config snapshot changes. */
+static const gchar * const CONFIG_CACHE_STAMP = VERSION ":1";
 
 Config::Config (Bus & bus, const std::string & name)
     : Object (ibus_bus_get_config (bus)),
+      m_save_id (0),
       m_section ("engine/" + name)
 {
+    gchar *path = g_build_filename (g_get_user_cache_dir (),
+                                    "ibus", "libpinyin",
+                                    (name + ".config").c_str (), NULL);
+    m_cache_file = path;
+    g_free (path);
+
     initDefaultValues ();
-    g_signal_connect (get<IBusConfig> (),
-                      "value-changed",
-                      G_CALLBACK (valueChangedCallback),
-                      this);
 }
 
 Config::~Config (void)
 {
+    if (m_save_id != 0) {
+        g_source_remove (m_save_id);
+        saveValues ();
+    }
+
+    std::map<std::string, GVariant *>::iterator it;
+    for (it = m_values.begin (); it != m_values.end (); ++it)
+        g_variant_unref (it->second);
 }
 
 void
@@ -62,6 +77,7 @@ Config::initDefaultValues (void)
     m_init_full_punct = TRUE;
     m_init_simp_chinese = TRUE;
     m_special_phrases = TRUE;
+    m_lua_call_timeout = 500;
 
     m_dictionaries = "";
 
@@ -77,55 +93,253 @@ Config::readDefaultValues (void)
 {
 }
 
-inline bool
-Config::read (const gchar * name,
-              bool          defval)
+void
+Config::loadValues (void)
 {
-    GVariant *value = NULL;
-    if ((value = ibus_config_get_value (get<IBusConfig> (), m_section.c_str (), name)) != NULL) {
-        if (g_variant_classify (value) == G_VARIANT_CLASS_BOOLEAN)
-            return g_variant_get_boolean (value);
+    gchar *contents = NULL;
+    gsize length = 0;
+
+    if (!g_file_get_contents (m_cache_file.c_str (), &contents, &length, NULL))
+        return;
+
+    GVariant *snapshot = g_variant_new_from_data (
+            G_VARIANT_TYPE ("(sa{sv})"), contents, length, FALSE,
+            g_free, contents);
+    g_variant_ref_sink (snapshot);
+
+    const gchar *stamp;
+    GVariant *values;
+    g_variant_get (snapshot, "(&s@a{sv})", &stamp, &values);
+
+    /* the snapshot is written by another version, drop it. */
+    if (g_strcmp0 (stamp, CONFIG_CACHE_STAMP) == 0) {
+        GVariantIter iter;
+        const gchar *name;
+        GVariant *value;
+        g_variant_iter_init (&iter, values);
+        while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+            GVariant * &slot = m_values[name];
+            if (slot != NULL)
+                g_variant_unref (slot);
+            slot = value;
+            valueChanged (m_section, name, value);
+        }
     }
 
-    // write default value to config
-    value = g_variant_new ("b", defval);
-    ibus_config_set_value (get<IBusConfig> (), m_section.c_str (), name, value);
+    g_variant_unref (values);
+    g_variant_unref (snapshot);
+}
+
+void
+Config::saveValues (void)
+{
+    GVariantBuilder builder;
+    g_variant_builder_init (&builder, G_VARIANT_TYPE ("a{sv}"));
+    std::map<std::string, GVariant *>::const_iterator it;
+    for (it = m_values.begin (); it != m_values.end (); ++it)
+        g_variant_builder_add (&builder, "{sv}", it->first.c_str (), it->second);
+
+    GVariant *snapshot = g_variant_new ("(sa{sv})", CONFIG_CACHE_STAMP, &builder);
+    g_variant_ref_sink (snapshot);
+
+    gchar *dirname = g_path_get_dirname (m_cache_file.c_str ());
+    g_mkdir_with_parents (dirname, 0700);
+    g_free (dirname);
 
-    return defval;
+    GError *error = NULL;
+    if (!g_file_set_contents (m_cache_file.c_str (),
+                              (const gchar *) g_variant_get_data (snapshot),
+                              g_variant_get_size (snapshot),
+                              &error)) {
+        g_warning ("Can not save config snapshot: %s", error->message);
+        g_error_free (error);
+    }
+    g_variant_unref (snapshot);
 }
 
-inline gint
-Config::read (const gchar * name,
-              gint          defval)
+gboolean
+Config::saveValuesCallback (Config *self)
 {
-    GVariant *value = NULL;
-    if ((value = ibus_config_get_value (get<IBusConfig> (), m_section.c_str (), name)) != NULL) {
-        if (g_variant_classify (value) == G_VARIANT_CLASS_INT32)
-            return g_variant_get_int32 (value);
+    self->m_save_id = 0;
+    self->saveValues ();
+    return FALSE;
+}
+
+void
+Config::storeValue (const std::string &name, GVariant *value)
+{
+    GVariant * &slot = m_values[name];
+    if (slot != NULL) {
+        if (g_variant_equal (slot, value))
+            return;
+        g_variant_unref (slot);
     }
+    slot = g_variant_ref_sink (value);
+    scheduleSave ();
+}
 
-    // write default value to config
-    value = g_variant_new ("i", defval);
-    ibus_config_set_value (get<IBusConfig> (), m_section.c_str (), name, value);
+void
+Config::scheduleSave (void)
+{
+    /* several values are usually changed together. */
+    if (m_save_id == 0)
+        m_save_id = g_timeout_add_seconds (1,
+                (GSourceFunc) saveValuesCallback, this);
+}
 
-    return defval;
+void
+Config::notifyObservers (const std::string &name)
+{
+    std::pair<Observers::iterator, Observers::iterator> range =
+            m_observers.equal_range (name);
+    for (Observers::iterator it = range.first; it != range.second; ++it)
+        it->second->configChanged (*this, name);
 }
 
-inline std::string
-Config::read (const gchar * name,
-              const gchar * defval)
+void
+Config::updateValue (const std::string &name, GVariant *value)
 {
-    GVariant *value = NULL;
-    if ((value = ibus_config_get_value (get<IBusConfig> (), m_section.c_str (), name)) != NULL) {
-        if (g_variant_classify (value) == G_VARIANT_CLASS_STRING)
-            return g_variant_get_string (value, NULL);
+    std::map<std::string, GVariant *>::const_iterator it = m_values.find (name);
+    if (it != m_values.end () && g_variant_equal (it->second, value))
+        return;
+
+    storeValue (name, value);
+    valueChanged (m_section, name, value);
+    notifyObservers (name);
+}
+
+void
+Config::resetValues (const std::vector<std::string> &names)
+{
+    std::vector<std::string> removed;
+    std::vector<std::string>::const_iterator name;
+    for (name = names.begin (); name != names.end (); ++name) {
+        std::map<std::string, GVariant *>::iterator it = m_values.find (*name);
+        if (it == m_values.end ())
+            continue;
+        g_variant_unref (it->second);
+        m_values.erase (it);
+        removed.push_back (*name);
     }
+    if (removed.empty ())
+        return;
+    scheduleSave ();
 
-    // write default value to config
-    value = g_variant_new ("s", defval);
-    ibus_config_set_value (get<IBusConfig> (), m_section.c_str (), name, value);
+    /* there is no default value per key, apply all the default values,
+     * then the values still set. */
+    initDefaultValues ();
+    std::map<std::string, GVariant *>::const_iterator it;
+    for (it = m_values.begin (); it != m_values.end (); ++it)
+        valueChanged (m_section, it->first, it->second);
 
-    return defval;
+    for (name = removed.begin (); name != removed.end (); ++name)
+        notifyObservers (*name);
+}
+
+void
+Config::setValue (const gchar *name, GVariant *value)
+{
+    ibus_config_set_value_async (get<IBusConfig> (), m_section.c_str (),
+                                 name, value, -1, NULL, NULL, NULL);
+}
+
+void
+Config::addObserver (const gchar *name, ConfigObserver *observer)
+{
+    m_observers.insert (Observers::value_type (name, observer));
+}
+
+void
+Config::removeObserver (ConfigObserver *observer)
+{
+    Observers::iterator it = m_observers.begin ();
+    while (it != m_observers.end ()) {
+        if (it->second == observer)
+            m_observers.erase (it++);
+        else
+            ++it;
+    }
+}
+
+void
+Config::fetchValues (void)
+{
+#if defined(HAVE_IBUS_CONFIG_GET_VALUES)
+    ibus_config_get_values_async (get<IBusConfig> (), m_section.c_str (),
+                                  -1, NULL,
+                                  (GAsyncReadyCallback) fetchValuesCallback,
+                                  this);
+#endif
+}
+
+void
+Config::fetchValuesCallback (GObject      *source,
+                             GAsyncResult *result,
+                             Config       *self)
+{
+#if defined(HAVE_IBUS_CONFIG_GET_VALUES)
+    GVariant *values =
+            ibus_config_get_values_async_finish (IBUS_CONFIG (source), result, NULL);
+    if (values == NULL)
+        return;
+
+    std::set<std::string> names;
+    GVariantIter iter;
+    const gchar *name;
+    GVariant *value;
+    g_variant_iter_init (&iter, values);
+    while (g_variant_iter_next (&iter, "{&sv}", &name, &value)) {
+        names.insert (name);
+        self->updateValue (name, value);
+        g_variant_unref (value);
+    }
+
+    /* only the keys set are returned, reset the others in the snapshot. */
+    std::vector<std::string> unset;
+    std::map<std::string, GVariant *>::const_iterator it;
+    for (it = self->m_values.begin (); it != self->m_values.end (); ++it) {
+        if (names.find (it->first) == names.end ())
+            unset.push_back (it->first);
+    }
+    self->resetValues (unset);
+
+    g_variant_unref (values);
+#endif
+}
+
+namespace {
+struct FetchValue {
+    Config *config;
+    std::string name;
+};
+};
+
+void
+Config::fetchValue (const gchar *name)
+{
+    FetchValue *fetch = new FetchValue;
+    fetch->config = this;
+    fetch->name = name;
+    ibus_config_get_value_async (get<IBusConfig> (), m_section.c_str (), name,
+                                 -1, NULL, fetchValueCallback, fetch);
+}
+
+void
+Config::fetchValueCallback (GObject      *source,
+                            GAsyncResult *result,
+                            gpointer      user_data)
+{
+    FetchValue *fetch = (FetchValue *) user_data;
+    GVariant *value =
+            ibus_config_get_value_async_finish (IBUS_CONFIG (source), result, NULL);
+    if (value != NULL) {
+        fetch->config->updateValue (fetch->name, value);
+        g_variant_unref (value);
+    } else {
+        /* the key is not set, drop the value of the snapshot. */
+        fetch->config->resetValues (std::vector<std::string> (1, fetch->name));
+    }
+    delete fetch;
 }
 
 gboolean
@@ -136,14 +350,4 @@ Config::valueChanged (const std::string &section,
     return FALSE;
 }
 
-void
-Config::valueChangedCallback (IBusConfig  *config,
-                              const gchar *section,
-                              const gchar *name,
-                              GVariant    *value,
-                              Config      *self)
-{
-    self->valueChanged (section, name, value);
-}
-
 };
@@ -25,7 +25,9 @@
 #  include <config.h>
 #endif
 
+#include <map>
 #include <string>
+#include <vector>
 #include <ibus.h>
 #include <pinyin.h>
 #include "PYUtil.h"
@@ -34,6 +36,14 @@
 namespace PY {
 
 class Bus;
+class Config;
+
+/* Receives the keys changed in a config, see Config::addObserver. */
+class ConfigObserver {
+public:
+    virtual ~ConfigObserver (void) { }
+    virtual void configChanged (Config &config, const std::string &name) = 0;
+};
 
 class Config : public Object {
 protected:
@@ -64,28 +74,58 @@ public:
     gboolean auxiliarySelectKeyF (void) const   { return m_auxiliary_select_key_f; }
     gboolean auxiliarySelectKeyKP (void) const  { return m_auxiliary_select_key_kp; }
     gboolean enterKey (void) const  { return m_enter_key; }
+    guint luaCallTimeout (void) const           { return m_lua_call_timeout; }
 
     std::string mainSwitch (void) const         { return m_main_switch; }
     std::string letterSwitch (void) const       { return m_letter_switch; }
     std::string punctSwitch (void) const        { return m_punct_switch; }
     std::string tradSwitch (void) const         { return m_trad_switch; }
 
+    /* write the value of key name to ibus config, without waiting. */
+    void setValue (const gchar *name, GVariant *value);
+
+    /* observer is notified after the value of key name is applied. */
+    void addObserver (const gchar *name, ConfigObserver *observer);
+    void removeObserver (ConfigObserver *observer);
+
 protected:
-    bool read (const gchar * name, bool defval);
-    gint read (const gchar * name, gint defval);
-    std::string read (const gchar * name, const gchar * defval);
-    void initDefaultValues (void);
+    virtual void initDefaultValues (void);
+
+    /* The values of the section are kept in a snapshot, which is saved
+     * to the user cache dir, so the engine could start with the values
+     * of last run without waiting for ibus config. The values are then
+     * refreshed asynchronously, and only the changed ones are applied.
+     * The keys unset in ibus config are reset to the default values. */
+    void loadValues (void);
+    void storeValue (const std::string &name, GVariant *value);
+    void fetchValues (void);
+    void fetchValue (const gchar *name);
 
     virtual void readDefaultValues (void);
+    virtual void updateValue (const std::string &name, GVariant *value);
+    virtual void resetValues (const std::vector<std::string> &names);
     virtual gboolean valueChanged (const std::string  &section,
                                    const std::string  &name,
                                    GVariant           *value);
 private:
-    static void valueChangedCallback (IBusConfig     *config,
-                                      const gchar    *section,
-                                      const gchar    *name,
-                                      GVariant       *value,
-                                      Config         *self);
+    void saveValues (void);
+    void scheduleSave (void);
+    void notifyObservers (const std::string &name);
+
+    static void fetchValuesCallback (GObject        *source,
+                                     GAsyncResult   *result,
+                                     Config         *self);
+    static void fetchValueCallback (GObject         *source,
+                                    GAsyncResult    *result,
+                                    gpointer         user_data);
+    static gboolean saveValuesCallback (Config      *self);
+
+    std::string m_cache_file;
+    std::map<std::string, GVariant *> m_values;
+    guint m_save_id;
+
+    typedef std::multimap<std::string, ConfigObserver *> Observers;
+    Observers m_observers;
 
 protected:
     std::string m_section;
@@ -120,6 +160,8 @@ protected:
 
     gboolean m_enter_key;
 
+    guint m_lua_call_timeout;
+
     std::string m_main_switch;
     std::string m_letter_switch;
     std::string m_punct_switch;
@@ -26,6 +26,7 @@ namespace PY {
 Editor::Editor (PinyinProperties & props, Config & config)
     : m_text (128),
       m_cursor (0),
+      m_learning (TRUE),
       m_props (props),
       m_config (config)
 {
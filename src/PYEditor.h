@@ -61,6 +61,12 @@ public:
         m_cursor = cursor;
     }
 
+    /* nothing is learned from the commits when learning is FALSE. */
+    void setLearning (gboolean learning)
+    {
+        m_learning = learning;
+    }
+
     /* signals */
     signal <void (Text &)> & signalCommitText (void)    { return m_signal_commit_text; }
 
@@ -155,6 +161,7 @@ protected:
 protected:
     String m_text;
     guint  m_cursor;
+    gboolean m_learning;
     PinyinProperties & m_props;
     Config & m_config;
 };
@@ -24,6 +24,7 @@
 #include <gdk/gdk.h>
 #include "PYPPinyinEngine.h"
 #include "PYPBopomofoEngine.h"
+#include "PYStats.h"
 
 namespace PY {
 /* code of engine class of GObject */
@@ -195,7 +196,13 @@ ibus_pinyin_engine_process_key_event (IBusEngine     *engine,
                                       guint           modifiers)
 {
     IBusPinyinEngine *pinyin = (IBusPinyinEngine *) engine;
-    return pinyin->engine->processKeyEvent (keyval, keycode, modifiers);
+
+    pinyin->engine->resetSerializedCandidates ();
+    Stats::reset ();
+    gboolean retval = pinyin->engine->processKeyEvent (keyval, keycode, modifiers);
+    if (G_UNLIKELY (Stats::enabled ()))
+        Stats::report (keyval, pinyin->engine->serializedCandidates ());
+    return retval;
 }
 
 #if IBUS_CHECK_VERSION (1, 5, 4)
@@ -247,10 +254,13 @@ FUNCTION(cursor_up,   cursorUp)
 FUNCTION(cursor_down, cursorDown)
 #undef FUNCTION
 
-Engine::Engine (IBusEngine *engine) : m_engine (engine)
+Engine::Engine (IBusEngine *engine)
+    : m_engine (engine),
+      m_serialized_candidates (0)
 {
 #if IBUS_CHECK_VERSION (1, 5, 4)
     m_input_purpose = IBUS_INPUT_PURPOSE_FREE_FORM;
+    m_input_hints = IBUS_INPUT_HINT_NONE;
 #endif
 }
 
@@ -264,11 +274,45 @@ Engine::contentIsPassword()
 #endif
 }
 
+gboolean
+Engine::contentIsLatin (void) const
+{
+#if IBUS_CHECK_VERSION (1, 5, 4)
+    switch (m_input_purpose) {
+    case IBUS_INPUT_PURPOSE_DIGITS:
+    case IBUS_INPUT_PURPOSE_NUMBER:
+    case IBUS_INPUT_PURPOSE_PHONE:
+    case IBUS_INPUT_PURPOSE_URL:
+    case IBUS_INPUT_PURPOSE_EMAIL:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+#else
+    return FALSE;
+#endif
+}
+
+gboolean
+Engine::contentSkipsLearning (void) const
+{
+#if IBUS_CHECK_VERSION (1, 5, 4)
+    guint hints = IBUS_INPUT_HINT_NO_SPELLCHECK;
+#if IBUS_CHECK_VERSION (1, 5, 25)
+    hints |= IBUS_INPUT_HINT_PRIVATE;
+#endif
+    return (m_input_hints & hints) != 0;
+#else
+    return FALSE;
+#endif
+}
+
 void
 Engine::focusOut (void)
 {
 #if IBUS_CHECK_VERSION (1, 5, 4)
     m_input_purpose = IBUS_INPUT_PURPOSE_FREE_FORM;
+    m_input_hints = IBUS_INPUT_HINT_NONE;
 #endif
 }
 
@@ -277,6 +321,7 @@ void
 Engine::setContentType (guint purpose, guint hints)
 {
     m_input_purpose = (IBusInputPurpose) purpose;
+    m_input_hints = (IBusInputHints) hints;
 }
 #endif
 
@@ -41,6 +41,15 @@ public:
     virtual ~Engine (void);
 
     gboolean contentIsPassword();
+    /* digits, numbers, phones, urls and emails never want chinese. */
+    gboolean contentIsLatin (void) const;
+    /* the application asks not to learn from this field. */
+    gboolean contentSkipsLearning (void) const;
+
+    /* candidates sent to the panel since last reset, the payload of
+     * a key event should be bounded by the page size. */
+    guint serializedCandidates (void) const { return m_serialized_candidates; }
+    void resetSerializedCandidates (void) { m_serialized_candidates = 0; }
 
     // virtual functions
     virtual gboolean processKeyEvent (guint keyval, guint keycode, guint modifiers) = 0;
@@ -97,11 +106,21 @@ protected:
 
     void updateLookupTable (LookupTable &table, gboolean visible) const
     {
+        m_serialized_candidates += table.size ();
         ibus_engine_update_lookup_table (m_engine, table, visible);
     }
 
+    /* only sends the current page, when the table holds at least four
+     * pages. */
     void updateLookupTableFast (LookupTable &table, gboolean visible) const
     {
+        guint size = table.size ();
+        guint page_size = table.pageSize ();
+        if (size >= page_size * 4) {
+            guint begin = table.cursorPos () / page_size * page_size;
+            size = MIN (page_size, size - begin);
+        }
+        m_serialized_candidates += size;
         ibus_engine_update_lookup_table_fast (m_engine, table, visible);
     }
 
@@ -130,8 +149,11 @@ protected:
 
 #if IBUS_CHECK_VERSION (1, 5, 4)
     IBusInputPurpose m_input_purpose;
+    IBusInputHints m_input_hints;
 #endif
 
+    mutable guint m_serialized_candidates;
+
 };
 
 gboolean pinyin_accelerator_name(guint keyval, guint modifiers,
@@ -767,6 +767,9 @@ EnglishEditor::removeCharAfter (void)
 gboolean
 EnglishEditor::train (const char *word, float delta)
 {
+    if (!m_learning)
+        return FALSE;
+
     float freq = 0;
     gboolean retval = m_english_database->getWordInfo (word, freq);
     if (retval) {
@@ -31,6 +31,8 @@ extern "C" {
 
 #include "PYEditor.h"
 #include "PYExtEditor.h"
+#include "PYFileMonitor.h"
+#include "PYWorker.h"
 
 namespace PY {
 
@@ -150,22 +152,63 @@ traditional_number(gint64 num)
  * foreach (results): 1, from get_retval; 2..n from get_retvals.
  */
 
+struct ExtEditor::LuaReload {
+    ExtEditor * editor;
+    IBusEnginePlugin * plugin;
+};
+
+static std::string
+user_lua_script (void)
+{
+    gchar * path = g_build_filename (g_get_user_config_dir (),
+                             "ibus", "libpinyin", "user.lua", NULL);
+    std::string filename = path;
+    g_free(path);
+    return filename;
+}
+
 ExtEditor::ExtEditor (PinyinProperties & props, Config & config)
     : Editor (props, config),
       m_mode (LABEL_NONE),
+      m_lua_reload (NULL),
+      m_lua_reload_pending (false),
       m_result_num (0),
       m_candidate (NULL),
-      m_candidates (NULL)
+      m_candidates (NULL),
+      m_result_cached (false)
 {
-    m_lua_plugin = ibus_engine_plugin_new ();
+    IBusEnginePlugin * plugin = newLuaPlugin ();
+    m_lua_plugin = plugin;
+    g_object_unref (plugin);
+
+    std::vector<std::string> files;
+    files.push_back (user_lua_script ());
+    m_monitor.reset (new FileMonitor (files));
+    m_monitor->signalChanged ().connect (this, &ExtEditor::reloadLuaScripts);
+}
 
-    loadLuaScript ( ".." G_DIR_SEPARATOR_S "lua" G_DIR_SEPARATOR_S "base.lua")||
-        loadLuaScript (PKGDATADIR G_DIR_SEPARATOR_S "base.lua");
+ExtEditor::~ExtEditor (void)
+{
+    /* the running reload finds the editor gone, and drops the state. */
+    if (m_lua_reload)
+        m_lua_reload->editor = NULL;
 
-    gchar * path = g_build_filename (g_get_user_config_dir (),
-                             "ibus", "libpinyin", "user.lua", NULL);
-    loadLuaScript(path);
-    g_free(path);
+    releaseCommandResult ();
+    clearCommandCache ();
+}
+
+IBusEnginePlugin *
+ExtEditor::newLuaPlugin (void)
+{
+    IBusEnginePlugin * plugin = ibus_engine_plugin_new ();
+
+    if (0 != ibus_engine_plugin_load_lua_script
+        (plugin, ".." G_DIR_SEPARATOR_S "lua" G_DIR_SEPARATOR_S "base.lua"))
+        ibus_engine_plugin_load_lua_script
+            (plugin, PKGDATADIR G_DIR_SEPARATOR_S "base.lua");
+
+    ibus_engine_plugin_load_lua_script (plugin, user_lua_script ().c_str ());
+    return plugin;
 }
 
 int
@@ -177,8 +220,75 @@ ExtEditor::loadLuaScript (std::string filename)
 void
 ExtEditor::resetLuaState ()
 {
-  g_object_unref (m_lua_plugin);
-  m_lua_plugin = ibus_engine_plugin_new ();
+  releaseCommandResult ();
+  clearCommandCache ();
+  IBusEnginePlugin * plugin = ibus_engine_plugin_new ();
+  m_lua_plugin = plugin;
+  g_object_unref (plugin);
+  m_signal_lua_plugin_changed ();
+}
+
+void
+ExtEditor::reloadLuaScripts (void)
+{
+    /* reload again after the running one, user.lua changed meanwhile. */
+    if (m_lua_reload) {
+        m_lua_reload_pending = true;
+        return;
+    }
+    m_lua_reload_pending = false;
+
+    m_lua_reload = new LuaReload;
+    m_lua_reload->editor = this;
+    m_lua_reload->plugin = NULL;
+    Worker::instance ().push (reloadJob, reloadDone, reloadFree, m_lua_reload);
+}
+
+void
+ExtEditor::reloadJob (gpointer data)
+{
+    LuaReload * reload = static_cast<LuaReload *> (data);
+    /* the new lua state is only touched by the worker until swapped. */
+    reload->plugin = newLuaPlugin ();
+}
+
+void
+ExtEditor::reloadDone (gpointer data)
+{
+    LuaReload * reload = static_cast<LuaReload *> (data);
+    ExtEditor * editor = reload->editor;
+
+    if (editor) {
+        editor->m_lua_reload = NULL;
+        editor->m_pending_lua_plugin = reload->plugin;
+        if (editor->m_text.empty ())
+            editor->swapLuaPlugin ();
+        if (editor->m_lua_reload_pending)
+            editor->reloadLuaScripts ();
+    }
+}
+
+void
+ExtEditor::reloadFree (gpointer data)
+{
+    LuaReload * reload = static_cast<LuaReload *> (data);
+
+    if (reload->plugin)
+        g_object_unref (reload->plugin);
+    delete reload;
+}
+
+void
+ExtEditor::swapLuaPlugin (void)
+{
+    if (!m_pending_lua_plugin)
+        return;
+
+    releaseCommandResult ();
+    clearCommandCache ();
+    m_lua_plugin = m_pending_lua_plugin;
+    m_pending_lua_plugin = NULL;
+    m_signal_lua_plugin_changed ();
 }
 
 
@@ -482,6 +592,8 @@ void
 ExtEditor::reset (void)
 {
     m_text = "";
+    /* the input is done, switch to the reloaded lua state. */
+    swapLuaPlugin ();
     updateStateFromInput ();
     update ();
 }
@@ -524,22 +636,14 @@ ExtEditor::selectCandidate (guint index)
     case LABEL_LIST_COMMANDS:
         {
             std::string prefix = m_text.substr (1, 2);
-            int len = prefix.length ();
-            const char * prefix_str = prefix.c_str ();
-            const GArray * commands = ibus_engine_plugin_get_available_commands (m_lua_plugin);
-            int match_count = -1;
-            for (int i = 0; i < static_cast<int>(commands->len); ++i) {
-                lua_command_t * command = &g_array_index (commands, lua_command_t, i);
-                if ( strncmp (prefix_str, command->command_name, len) == 0 ) {
-                    match_count++;
-                }
-                if ( match_count == static_cast<int>(index) ) {
-                    m_text.clear ();
-                    m_text = "i";
-                    m_text += command->command_name;
-                    m_cursor = m_text.length ();
-                    break;
-                }
+            guint num = 0;
+            const lua_command_t * commands =
+                ibus_engine_plugin_get_commands_with_prefix (m_lua_plugin, prefix.c_str (), &num);
+            if ( index < num ) {
+                m_text.clear ();
+                m_text = "i";
+                m_text += commands[index].command_name;
+                m_cursor = m_text.length ();
             }
             updateStateFromInput ();
             update ();
@@ -704,20 +808,16 @@ ExtEditor::fillCommandCandidates (std::string prefix)
     clearLookupTable ();
 
     /* fill candidates here. */
-    int len = prefix.length ();
-    const char * prefix_str = prefix.c_str ();
-    const GArray * commands = ibus_engine_plugin_get_available_commands (m_lua_plugin);
-    int count = -1;
-    for ( int i = 0; i < static_cast<int>(commands->len); ++i) {
-        lua_command_t * command = &g_array_index (commands, lua_command_t, i);
-        if ( strncmp (prefix_str, command->command_name, len) == 0) {
-            count++;
-            std::string candidate = command->command_name;
-            candidate += ".";
-            candidate += command->description;
-            m_lookup_table.setLabel (count, Text (""));
-            m_lookup_table.appendCandidate (Text (candidate));
-        }
+    guint num = 0;
+    const lua_command_t * commands =
+        ibus_engine_plugin_get_commands_with_prefix (m_lua_plugin, prefix.c_str (), &num);
+    m_lookup_table.setLabels (LookupTable::LABEL_SET_EMPTY);
+    for ( guint i = 0; i < num; ++i) {
+        const lua_command_t * command = &commands[i];
+        std::string candidate = command->command_name;
+        candidate += ".";
+        candidate += command->description;
+        m_lookup_table.appendCandidate (Text (candidate));
     }
 
     return true;
@@ -730,24 +830,31 @@ ExtEditor::fillCommand (std::string command_name, const char * argument)
     if ( NULL == command )
         return false;
 
-    if ( m_result_num != 0) {
-        if ( m_result_num == 1) {
-            ibus_engine_plugin_free_candidate ((lua_command_candidate_t *)m_candidate);
-            m_candidate = NULL;
-        }else{
-            for ( int i = 0; i < m_result_num; ++i) {
-                const lua_command_candidate_t * candidate = g_array_index (m_candidates, lua_command_candidate_t *, i);
-                ibus_engine_plugin_free_candidate ((lua_command_candidate_t *)candidate);
-            }
+    releaseCommandResult ();
 
-            g_array_free (m_candidates, TRUE);
-            m_candidates = NULL;
-        }
-        m_result_num = 0;
-        g_assert (m_candidates == NULL && m_candidate == NULL);
-    }
+    /* pure commands skip the lua call for the same argument. */
+    std::string key = command_name;
+    key += ' ';
+    if ( argument )
+        key += argument;
+
+    if ( !command->pure || !lookupCommandCache (key) ) {
+        guint timeouts = 0, new_timeouts = 0;
+        ibus_engine_plugin_get_call_stats (m_lua_plugin, NULL, &timeouts);
+
+        ibus_engine_plugin_set_call_timeout (m_lua_plugin, m_config.luaCallTimeout ());
+        m_result_num = ibus_engine_plugin_call (m_lua_plugin, command->lua_function_name, argument);
 
-    m_result_num = ibus_engine_plugin_call (m_lua_plugin, command->lua_function_name, argument);
+        if ( 1 == m_result_num )
+            m_candidate = ibus_engine_plugin_get_retval (m_lua_plugin);
+        else if ( m_result_num > 1 )
+            m_candidates = ibus_engine_plugin_get_retvals (m_lua_plugin);
+
+        /* do not remember the timed out results. */
+        ibus_engine_plugin_get_call_stats (m_lua_plugin, NULL, &new_timeouts);
+        if ( command->pure && timeouts == new_timeouts )
+            insertCommandCache (key);
+    }
 
     if ( 1 == m_result_num )
         m_mode = LABEL_LIST_SINGLE;
@@ -755,25 +862,18 @@ ExtEditor::fillCommand (std::string command_name, const char * argument)
     clearLookupTable ();
 
     //Generate labels according to m_mode
-    if ( LABEL_LIST_DIGIT == m_mode ) {
-        for ( int i = 1; i <= 10; ++i )
-            m_lookup_table.setLabel ( i - 1, Text (i - 1 + '1') );
-    }
+    if ( LABEL_LIST_DIGIT == m_mode )
+        m_lookup_table.setLabels (LookupTable::LABEL_SET_DIGIT);
 
-    if ( LABEL_LIST_ALPHA == m_mode) {
-        for ( int i = 1; i <= 10; ++i )
-            m_lookup_table.setLabel ( i - 1, Text (i - 1 + 'a') );
-    }
+    if ( LABEL_LIST_ALPHA == m_mode)
+        m_lookup_table.setLabels (LookupTable::LABEL_SET_ALPHA);
 
-    if ( LABEL_LIST_NONE == m_mode || LABEL_LIST_SINGLE == m_mode) {
-        for ( int i = 1; i <= 10; ++i)
-            m_lookup_table.setLabel ( i - 1, Text (""));
-    }
+    if ( LABEL_LIST_NONE == m_mode || LABEL_LIST_SINGLE == m_mode)
+        m_lookup_table.setLabels (LookupTable::LABEL_SET_EMPTY);
 
     //Generate candidates
     std::string result;
     if ( 1 == m_result_num ) {
-        m_candidate = ibus_engine_plugin_get_retval (m_lua_plugin);
         result = "";
         if ( m_candidate->content ) {
             result = m_candidate->content;
@@ -790,7 +890,6 @@ ExtEditor::fillCommand (std::string command_name, const char * argument)
 
         m_lookup_table.appendCandidate (Text (result));
     }else if (m_result_num > 1) {
-        m_candidates = ibus_engine_plugin_get_retvals (m_lua_plugin);
         for ( int i = 0; i < m_result_num; ++i) {
             const lua_command_candidate_t * candidate = g_array_index (m_candidates, lua_command_candidate_t *, i);
             result = "";
@@ -814,15 +913,90 @@ ExtEditor::fillCommand (std::string command_name, const char * argument)
     return true;
 }
 
+void
+ExtEditor::freeCommandResult (CommandResult & result)
+{
+    if ( result.num == 1 ) {
+        ibus_engine_plugin_free_candidate ((lua_command_candidate_t *)result.candidate);
+    } else if ( result.num > 1 ) {
+        for ( int i = 0; i < result.num; ++i) {
+            const lua_command_candidate_t * candidate = g_array_index (result.candidates, lua_command_candidate_t *, i);
+            ibus_engine_plugin_free_candidate ((lua_command_candidate_t *)candidate);
+        }
+        g_array_free (result.candidates, TRUE);
+    }
+    result.num = 0;
+    result.candidate = NULL;
+    result.candidates = NULL;
+}
+
+void
+ExtEditor::releaseCommandResult (void)
+{
+    /* the cached results are owned by the cache. */
+    if ( !m_result_cached ) {
+        CommandResult result = { m_result_num, m_candidate, m_candidates };
+        freeCommandResult (result);
+    }
+
+    m_result_num = 0;
+    m_candidate = NULL;
+    m_candidates = NULL;
+    m_result_cached = false;
+}
+
+bool
+ExtEditor::lookupCommandCache (const std::string & key)
+{
+    std::map<std::string, CommandResultList::iterator>::iterator iter =
+        m_command_cache_index.find (key);
+    if ( iter == m_command_cache_index.end () )
+        return false;
+
+    /* move to the most recently used position. */
+    m_command_cache.splice (m_command_cache.begin (), m_command_cache, iter->second);
+
+    const CommandResult & result = iter->second->second;
+    m_result_num = result.num;
+    m_candidate = result.candidate;
+    m_candidates = result.candidates;
+    m_result_cached = true;
+    return true;
+}
+
+void
+ExtEditor::insertCommandCache (const std::string & key)
+{
+    if ( m_command_cache.size () >= m_command_cache_size ) {
+        CommandResultList::iterator last = --m_command_cache.end ();
+        m_command_cache_index.erase (last->first);
+        freeCommandResult (last->second);
+        m_command_cache.erase (last);
+    }
+
+    CommandResult result = { m_result_num, m_candidate, m_candidates };
+    m_command_cache.push_front (std::make_pair (key, result));
+    m_command_cache_index[key] = m_command_cache.begin ();
+    m_result_cached = true;
+}
+
+void
+ExtEditor::clearCommandCache (void)
+{
+    CommandResultList::iterator iter;
+    for ( iter = m_command_cache.begin (); iter != m_command_cache.end (); ++iter )
+        freeCommandResult (iter->second);
+    m_command_cache.clear ();
+    m_command_cache_index.clear ();
+}
+
 bool
 ExtEditor::fillChineseNumber(gint64 num)
 {
     clearLookupTable();
 
-    if ( LABEL_LIST_NUMBERS == m_mode) {
-        for ( int i = 1; i <= 10; ++i )
-            m_lookup_table.setLabel ( i - 1, Text (i - 1 + 'a') );
-    }
+    if ( LABEL_LIST_NUMBERS == m_mode)
+        m_lookup_table.setLabels (LookupTable::LABEL_SET_ALPHA);
 
     std::string result = simplified_number(num);
     if ( !result.empty() ){
@@ -22,16 +22,21 @@
 #define __PY_EXT_EDITOR_
 
 #include <glib.h>
+#include <list>
+#include <map>
+#include <string>
 
 typedef struct _IBusEnginePlugin IBusEnginePlugin;
 typedef struct _lua_command_candidate_t lua_command_candidate_t;
 
 namespace PY {
 
+class FileMonitor;
 
 class ExtEditor : public Editor {
 public:
     ExtEditor (PinyinProperties & props, Config & config);
+    virtual ~ExtEditor (void);
 
     virtual gboolean processKeyEvent (guint keyval, guint keycode, guint modifiers);
     virtual void pageUp (void);
@@ -44,8 +49,22 @@ public:
 
     int loadLuaScript (std::string filename);
     void resetLuaState (void);
+    void reloadLuaScripts (void);
+
+    IBusEnginePlugin * luaPlugin (void) { return m_lua_plugin; }
+
+    signal <void ()> & signalLuaPluginChanged (void)
+                                                { return m_signal_lua_plugin_changed; }
 
 private:
+    /* Build a new lua state in worker thread, and swap it in main loop. */
+    struct LuaReload;
+    static IBusEnginePlugin * newLuaPlugin (void);
+    static void reloadJob (gpointer data);
+    static void reloadDone (gpointer data);
+    static void reloadFree (gpointer data);
+    void swapLuaPlugin (void);
+
     bool updateStateFromInput (void);
 
     /* Fill lookup table, and update preedit string. */
@@ -55,6 +74,20 @@ private:
 
     bool fillChineseNumber(gint64 num);
 
+    /* Saved results of lua command calls. */
+    struct CommandResult {
+        int num;
+        const lua_command_candidate_t * candidate;
+        GArray * candidates;
+    };
+    typedef std::list<std::pair<std::string, CommandResult> > CommandResultList;
+
+    void releaseCommandResult (void);
+    static void freeCommandResult (CommandResult & result);
+    bool lookupCommandCache (const std::string & key);
+    void insertCommandCache (const std::string & key);
+    void clearCommandCache (void);
+
     /* Auxiliary functions for lookup table */
     void clearLookupTable (void);
     void updateLookupTable (void);
@@ -87,6 +120,13 @@ private:
     LabelMode m_mode;
     Pointer<IBusEnginePlugin> m_lua_plugin;
 
+    //new lua state, swapped in when no input is in flight.
+    Pointer<IBusEnginePlugin> m_pending_lua_plugin;
+    LuaReload * m_lua_reload;
+    bool m_lua_reload_pending;
+    std::unique_ptr<FileMonitor> m_monitor;
+    signal <void ()> m_signal_lua_plugin_changed;
+
     std::string m_preedit_text;
     std::string m_auxiliary_text;
 
@@ -96,6 +136,12 @@ private:
     int m_result_num;
     const lua_command_candidate_t * m_candidate;
     GArray * m_candidates;
+    bool m_result_cached;
+
+    //LRU cache of pure lua command results, keyed by command and argument.
+    CommandResultList m_command_cache;
+    std::map<std::string, CommandResultList::iterator> m_command_cache_index;
+    const static guint m_command_cache_size = 32;
 
     const static int m_aux_text_len = 50;
 };
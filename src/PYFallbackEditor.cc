@@ -24,6 +24,41 @@
 
 namespace PY {
 
+/* immortal texts of ascii chars in half and full width forms. */
+static IBusText *char_texts[2][0x80];
+/* immortal texts of punctuation literals, keyed by address. */
+static GHashTable *literal_texts = NULL;
+
+IBusText *
+FallbackEditor::charText (guint ch, gboolean full)
+{
+    if (G_UNLIKELY (ch >= 0x80))
+        return NULL;
+
+    IBusText *&text = char_texts[full ? 1 : 0][ch];
+    if (G_UNLIKELY (text == NULL)) {
+        text = ibus_text_new_from_unichar (
+            full ? HalfFullConverter::toFull (ch) : ch);
+        g_object_ref_sink (text);
+    }
+    return text;
+}
+
+IBusText *
+FallbackEditor::literalText (const gchar *str)
+{
+    if (G_UNLIKELY (literal_texts == NULL))
+        literal_texts = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+    IBusText *text = (IBusText *) g_hash_table_lookup (literal_texts, str);
+    if (G_UNLIKELY (text == NULL)) {
+        text = ibus_text_new_from_static_string (str);
+        g_object_ref_sink (text);
+        g_hash_table_insert (literal_texts, (gpointer) str, text);
+    }
+    return text;
+}
+
 inline gboolean
 FallbackEditor::processPunctForSimplifiedChinese (guint keyval, guint keycode, guint modifiers)
 {
@@ -173,7 +208,7 @@ FallbackEditor::processPunct (guint keyval, guint keycode, guint modifiers)
     /* English mode */
     if (G_UNLIKELY (!m_props.modeChinese ())) {
         if (G_UNLIKELY (m_props.modeFull ()))
-            commit (HalfFullConverter::toFull (keyval));
+            commit (keyval, TRUE);
         else
             commit (keyval);
         return TRUE;
@@ -190,7 +225,7 @@ FallbackEditor::processPunct (guint keyval, guint keycode, guint modifiers)
                     return TRUE;
             }
         }
-        commit (m_props.modeFull () ? HalfFullConverter::toFull (keyval) : keyval);
+        commit (keyval, m_props.modeFull ());
     }
     return TRUE;
 }
@@ -216,7 +251,7 @@ FallbackEditor::processKeyEvent (guint keyval, guint keycode, guint modifiers)
         case IBUS_a ... IBUS_z:
         case IBUS_A ... IBUS_Z:
             if (modifiers == 0) {
-                commit (m_props.modeFull () ? HalfFullConverter::toFull (keyval) : keyval);
+                commit (keyval, m_props.modeFull ());
                 retval = TRUE;
             }
             break;
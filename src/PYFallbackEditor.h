@@ -23,6 +23,7 @@
 
 #include "PYText.h"
 #include "PYEditor.h"
+#include "PYHalfFullConverter.h"
 
 namespace PY {
 
@@ -43,30 +44,31 @@ public:
     }
 
 private:
-    void commit (gchar ch)
-    {
-        gchar str[2] = {ch, 0};
-        StaticText text (str);
-        commitText (text);
-    }
+    /* the committed texts of ascii chars and punctuation strings are
+     * created once and shared, no allocation on later commits. */
+    static IBusText * charText (guint ch, gboolean full);
+    static IBusText * literalText (const gchar *str);
 
-    void commit (gunichar ch)
+    void commit (guint ch, gboolean full = FALSE)
     {
-        Text text (ch);
-        commitText (text);
+        IBusText *cached = charText (ch, full);
+        if (G_LIKELY (cached != NULL)) {
+            Text text (cached);
+            commitText (text);
+        }
+        else {
+            Text text (full ? HalfFullConverter::toFull (ch) : ch);
+            commitText (text);
+        }
     }
 
+    /* str must be a string literal. */
     void commit (const gchar *str)
     {
-        StaticText text (str);
+        Text text (literalText (str));
         commitText (text);
     }
 
-    void commit (const String &str)
-    {
-        commit ((const gchar *)str);
-    }
-
     gboolean processPunct (guint keyval, guint keycode, guint modifiers);
     gboolean processPunctForSimplifiedChinese (guint keyval, guint keycode, guint modifiers);
     gboolean processPunctForTraditionalChinese (guint keyval, guint keycode, guint modifiers);
@@ -0,0 +1,87 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "PYFileMonitor.h"
+
+/* editors usually save a file with several events, wait for the last one. */
+#define FILE_MONITOR_DELAY  500
+
+using namespace PY;
+
+FileMonitor::FileMonitor (const std::vector<std::string> &files)
+    : m_timeout_id (0)
+{
+    for (guint i = 0; i < files.size (); i++) {
+        GFile *file = g_file_new_for_path (files[i].c_str ());
+        GFileMonitor *monitor = g_file_monitor_file
+            (file, G_FILE_MONITOR_NONE, NULL, NULL);
+        g_object_unref (file);
+
+        if (monitor == NULL) {
+            g_warning ("can't monitor file %s", files[i].c_str ());
+            continue;
+        }
+
+        g_signal_connect (monitor, "changed",
+                          G_CALLBACK (changedCallback), this);
+        m_monitors.push_back (monitor);
+    }
+}
+
+FileMonitor::~FileMonitor (void)
+{
+    if (m_timeout_id != 0)
+        g_source_remove (m_timeout_id);
+
+    for (guint i = 0; i < m_monitors.size (); i++) {
+        g_signal_handlers_disconnect_by_func
+            (m_monitors[i], (gpointer) changedCallback, this);
+        g_file_monitor_cancel (m_monitors[i]);
+        g_object_unref (m_monitors[i]);
+    }
+}
+
+void
+FileMonitor::changedCallback (GFileMonitor *monitor,
+                              GFile *file,
+                              GFile *other_file,
+                              GFileMonitorEvent event,
+                              gpointer user_data)
+{
+    FileMonitor *self = static_cast<FileMonitor *> (user_data);
+
+    if (event == G_FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED)
+        return;
+
+    if (self->m_timeout_id != 0)
+        g_source_remove (self->m_timeout_id);
+    self->m_timeout_id = g_timeout_add (FILE_MONITOR_DELAY,
+                                        timeoutCallback, self);
+}
+
+gboolean
+FileMonitor::timeoutCallback (gpointer user_data)
+{
+    FileMonitor *self = static_cast<FileMonitor *> (user_data);
+    self->m_timeout_id = 0;
+    self->m_signal_changed ();
+    return FALSE;
+}
@@ -0,0 +1,56 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef __PY_FILE_MONITOR_H_
+#define __PY_FILE_MONITOR_H_
+
+#include <string>
+#include <vector>
+#include <gio/gio.h>
+#include "PYSignal.h"
+
+namespace PY {
+
+/* watch some files, and emit changed signal once the changes settle. */
+class FileMonitor {
+public:
+    FileMonitor (const std::vector<std::string> &files);
+    virtual ~FileMonitor (void);
+
+    signal <void ()> & signalChanged (void) { return m_signal_changed; }
+
+private:
+    static void changedCallback (GFileMonitor *monitor,
+                                 GFile *file,
+                                 GFile *other_file,
+                                 GFileMonitorEvent event,
+                                 gpointer user_data);
+    static gboolean timeoutCallback (gpointer user_data);
+
+private:
+    std::vector<GFileMonitor *> m_monitors;
+    guint m_timeout_id;
+
+    signal <void ()> m_signal_changed;
+};
+
+};
+
+#endif
@@ -22,6 +22,7 @@
 #define __PY_HALF_FULL_CONVERTER_H_
 
 #include <glib.h>
+#include "PYString.h"
 
 namespace PY {
 
@@ -31,8 +32,8 @@ public:
     static gunichar toFull (gunichar ch);
     static gunichar toHalf (gunichar ch);
 
-private:
-    const static guint m_table[][3];
+    /* append the full width form of utf8 str to out */
+    static void toFull (const gchar *str, String &out);
 };
 
 };
@@ -0,0 +1,260 @@
+/* This file is generated by scripts/genhalffulltable.py */
+
+static const gunichar
+half_full_latin1_table[0x0100 - 0x0000] = {
+    0x0000, 0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007,
+    0x0008, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, 0x000F,
+    0x0010, 0x0011, 0x0012, 0x0013, 0x0014, 0x0015, 0x0016, 0x0017,
+    0x0018, 0x0019, 0x001A, 0x001B, 0x001C, 0x001D, 0x001E, 0x001F,
+    0x3000, 0xFF01, 0xFF02, 0xFF03, 0xFF04, 0xFF05, 0xFF06, 0xFF07,
+    0xFF08, 0xFF09, 0xFF0A, 0xFF0B, 0xFF0C, 0xFF0D, 0xFF0E, 0xFF0F,
+    0xFF10, 0xFF11, 0xFF12, 0xFF13, 0xFF14, 0xFF15, 0xFF16, 0xFF17,
+    0xFF18, 0xFF19, 0xFF1A, 0xFF1B, 0xFF1C, 0xFF1D, 0xFF1E, 0xFF1F,
+    0xFF20, 0xFF21, 0xFF22, 0xFF23, 0xFF24, 0xFF25, 0xFF26, 0xFF27,
+    0xFF28, 0xFF29, 0xFF2A, 0xFF2B, 0xFF2C, 0xFF2D, 0xFF2E, 0xFF2F,
+    0xFF30, 0xFF31, 0xFF32, 0xFF33, 0xFF34, 0xFF35, 0xFF36, 0xFF37,
+    0xFF38, 0xFF39, 0xFF3A, 0xFF3B, 0xFF3C, 0xFF3D, 0xFF3E, 0xFF3F,
+    0xFF40, 0xFF41, 0xFF42, 0xFF43, 0xFF44, 0xFF45, 0xFF46, 0xFF47,
+    0xFF48, 0xFF49, 0xFF4A, 0xFF4B, 0xFF4C, 0xFF4D, 0xFF4E, 0xFF4F,
+    0xFF50, 0xFF51, 0xFF52, 0xFF53, 0xFF54, 0xFF55, 0xFF56, 0xFF57,
+    0xFF58, 0xFF59, 0xFF5A, 0xFF5B, 0xFF5C, 0xFF5D, 0xFF5E, 0x007F,
+    0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+    0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+    0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+    0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+    0x00A0, 0x00A1, 0xFFE0, 0xFFE1, 0x00A4, 0xFFE5, 0xFFE4, 0x00A7,
+    0x00A8, 0x00A9, 0x00AA, 0x00AB, 0xFFE2, 0x00AD, 0x00AE, 0xFFE3,
+    0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+    0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+    0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+    0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+    0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+    0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+    0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+    0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+    0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+    0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+};
+
+static const gunichar
+half_full_halfwidth_table[0xFFEF - 0xFF61] = {
+    0x3002, 0x300C, 0x300D, 0x3001, 0x30FB, 0x30F2, 0x30A1, 0x30A3,
+    0x30A5, 0x30A7, 0x30A9, 0x30E3, 0x30E5, 0x30E7, 0x30C3, 0x30FC,
+    0x30A2, 0x30A4, 0x30A6, 0x30A8, 0x30AA, 0x30AB, 0x30AD, 0x30AF,
+    0x30B1, 0x30B3, 0x30B5, 0x30B7, 0x30B9, 0x30BB, 0x30BD, 0x30BF,
+    0x30C1, 0x30C4, 0x30C6, 0x30C8, 0x30CA, 0x30CB, 0x30CC, 0x30CD,
+    0x30CE, 0x30CF, 0x30D2, 0x30D5, 0x30D8, 0x30DB, 0x30DE, 0x30DF,
+    0x30E0, 0x30E1, 0x30E2, 0x30E4, 0x30E6, 0x30E8, 0x30E9, 0x30EA,
+    0x30EB, 0x30EC, 0x30ED, 0x30EF, 0x30F3, 0xFF9E, 0xFF9F, 0x3164,
+    0x3131, 0x3132, 0x3133, 0x3134, 0x3135, 0x3136, 0x3137, 0x3138,
+    0x3139, 0x313A, 0x313B, 0x313C, 0x313D, 0x313E, 0x313F, 0x3140,
+    0x3141, 0x3142, 0x3143, 0x3144, 0x3145, 0x3146, 0x3147, 0x3148,
+    0x3149, 0x314A, 0x314B, 0x314C, 0x314D, 0x314E, 0xFFBF, 0xFFC0,
+    0xFFC1, 0x314F, 0x3150, 0x3151, 0x3152, 0x3153, 0x3154, 0xFFC8,
+    0xFFC9, 0x3155, 0x3156, 0x3157, 0x3158, 0x3159, 0x315A, 0xFFD0,
+    0xFFD1, 0x315B, 0x315C, 0x315D, 0x315E, 0x315F, 0x3160, 0x3161,
+    0x3162, 0x3163, 0xFFDB, 0xFFDC, 0xFFDD, 0xFFDE, 0xFFDF, 0xFFE0,
+    0xFFE1, 0xFFE2, 0xFFE3, 0xFFE4, 0xFFE5, 0xFFE6, 0xFFE7, 0xFFE8,
+    0x2190, 0x2191, 0x2192, 0x2193, 0x25A0, 0x25CB,
+};
+
+static const gunichar
+half_full_rest_table[][3] = {
+    { 0x20A9, 0xFFE6, 1 },
+};
+
+static const gunichar
+full_half_cjk_table[0x3190 - 0x3000] = {
+    0x0020, 0xFF64, 0xFF61, 0x3003, 0x3004, 0x3005, 0x3006, 0x3007,
+    0x3008, 0x3009, 0x300A, 0x300B, 0xFF62, 0xFF63, 0x300E, 0x300F,
+    0x3010, 0x3011, 0x3012, 0x3013, 0x3014, 0x3015, 0x3016, 0x3017,
+    0x3018, 0x3019, 0x301A, 0x301B, 0x301C, 0x301D, 0x301E, 0x301F,
+    0x3020, 0x3021, 0x3022, 0x3023, 0x3024, 0x3025, 0x3026, 0x3027,
+    0x3028, 0x3029, 0x302A, 0x302B, 0x302C, 0x302D, 0x302E, 0x302F,
+    0x3030, 0x3031, 0x3032, 0x3033, 0x3034, 0x3035, 0x3036, 0x3037,
+    0x3038, 0x3039, 0x303A, 0x303B, 0x303C, 0x303D, 0x303E, 0x303F,
+    0x3040, 0x3041, 0x3042, 0x3043, 0x3044, 0x3045, 0x3046, 0x3047,
+    0x3048, 0x3049, 0x304A, 0x304B, 0x304C, 0x304D, 0x304E, 0x304F,
+    0x3050, 0x3051, 0x3052, 0x3053, 0x3054, 0x3055, 0x3056, 0x3057,
+    0x3058, 0x3059, 0x305A, 0x305B, 0x305C, 0x305D, 0x305E, 0x305F,
+    0x3060, 0x3061, 0x3062, 0x3063, 0x3064, 0x3065, 0x3066, 0x3067,
+    0x3068, 0x3069, 0x306A, 0x306B, 0x306C, 0x306D, 0x306E, 0x306F,
+    0x3070, 0x3071, 0x3072, 0x3073, 0x3074, 0x3075, 0x3076, 0x3077,
+    0x3078, 0x3079, 0x307A, 0x307B, 0x307C, 0x307D, 0x307E, 0x307F,
+    0x3080, 0x3081, 0x3082, 0x3083, 0x3084, 0x3085, 0x3086, 0x3087,
+    0x3088, 0x3089, 0x308A, 0x308B, 0x308C, 0x308D, 0x308E, 0x308F,
+    0x3090, 0x3091, 0x3092, 0x3093, 0x3094, 0x3095, 0x3096, 0x3097,
+    0x3098, 0x3099, 0x309A, 0x309B, 0x309C, 0x309D, 0x309E, 0x309F,
+    0x30A0, 0xFF67, 0xFF71, 0xFF68, 0xFF72, 0xFF69, 0xFF73, 0xFF6A,
+    0xFF74, 0xFF6B, 0xFF75, 0xFF76, 0x30AC, 0xFF77, 0x30AE, 0xFF78,
+    0x30B0, 0xFF79, 0x30B2, 0xFF7A, 0x30B4, 0xFF7B, 0x30B6, 0xFF7C,
+    0x30B8, 0xFF7D, 0x30BA, 0xFF7E, 0x30BC, 0xFF7F, 0x30BE, 0xFF80,
+    0x30C0, 0xFF81, 0x30C2, 0xFF6F, 0xFF82, 0x30C5, 0xFF83, 0x30C7,
+    0xFF84, 0x30C9, 0xFF85, 0xFF86, 0xFF87, 0xFF88, 0xFF89, 0xFF8A,
+    0x30D0, 0x30D1, 0xFF8B, 0x30D3, 0x30D4, 0xFF8C, 0x30D6, 0x30D7,
+    0xFF8D, 0x30D9, 0x30DA, 0xFF8E, 0x30DC, 0x30DD, 0xFF8F, 0xFF90,
+    0xFF91, 0xFF92, 0xFF93, 0xFF6C, 0xFF94, 0xFF6D, 0xFF95, 0xFF6E,
+    0xFF96, 0xFF97, 0xFF98, 0xFF99, 0xFF9A, 0xFF9B, 0x30EE, 0xFF9C,
+    0x30F0, 0x30F1, 0xFF66, 0xFF9D, 0x30F4, 0x30F5, 0x30F6, 0x30F7,
+    0x30F8, 0x30F9, 0x30FA, 0xFF65, 0xFF70, 0x30FD, 0x30FE, 0x30FF,
+    0x3100, 0x3101, 0x3102, 0x3103, 0x3104, 0x3105, 0x3106, 0x3107,
+    0x3108, 0x3109, 0x310A, 0x310B, 0x310C, 0x310D, 0x310E, 0x310F,
+    0x3110, 0x3111, 0x3112, 0x3113, 0x3114, 0x3115, 0x3116, 0x3117,
+    0x3118, 0x3119, 0x311A, 0x311B, 0x311C, 0x311D, 0x311E, 0x311F,
+    0x3120, 0x3121, 0x3122, 0x3123, 0x3124, 0x3125, 0x3126, 0x3127,
+    0x3128, 0x3129, 0x312A, 0x312B, 0x312C, 0x312D, 0x312E, 0x312F,
+    0x3130, 0xFFA1, 0xFFA2, 0xFFA3, 0xFFA4, 0xFFA5, 0xFFA6, 0xFFA7,
+    0xFFA8, 0xFFA9, 0xFFAA, 0xFFAB, 0xFFAC, 0xFFAD, 0xFFAE, 0xFFAF,
+    0xFFB0, 0xFFB1, 0xFFB2, 0xFFB3, 0xFFB4, 0xFFB5, 0xFFB6, 0xFFB7,
+    0xFFB8, 0xFFB9, 0xFFBA, 0xFFBB, 0xFFBC, 0xFFBD, 0xFFBE, 0xFFC2,
+    0xFFC3, 0xFFC4, 0xFFC5, 0xFFC6, 0xFFC7, 0xFFCA, 0xFFCB, 0xFFCC,
+    0xFFCD, 0xFFCE, 0xFFCF, 0xFFD2, 0xFFD3, 0xFFD4, 0xFFD5, 0xFFD6,
+    0xFFD7, 0xFFD8, 0xFFD9, 0xFFDA, 0xFFA0, 0x3165, 0x3166, 0x3167,
+    0x3168, 0x3169, 0x316A, 0x316B, 0x316C, 0x316D, 0x316E, 0x316F,
+    0x3170, 0x3171, 0x3172, 0x3173, 0x3174, 0x3175, 0x3176, 0x3177,
+    0x3178, 0x3179, 0x317A, 0x317B, 0x317C, 0x317D, 0x317E, 0x317F,
+    0x3180, 0x3181, 0x3182, 0x3183, 0x3184, 0x3185, 0x3186, 0x3187,
+    0x3188, 0x3189, 0x318A, 0x318B, 0x318C, 0x318D, 0x318E, 0x318F,
+};
+
+static const gunichar
+full_half_fullwidth_table[0xFFEF - 0xFF00] = {
+    0xFF00, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,
+    0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0xFF5F,
+    0xFF60, 0xFF61, 0xFF62, 0xFF63, 0xFF64, 0xFF65, 0xFF66, 0xFF67,
+    0xFF68, 0xFF69, 0xFF6A, 0xFF6B, 0xFF6C, 0xFF6D, 0xFF6E, 0xFF6F,
+    0xFF70, 0xFF71, 0xFF72, 0xFF73, 0xFF74, 0xFF75, 0xFF76, 0xFF77,
+    0xFF78, 0xFF79, 0xFF7A, 0xFF7B, 0xFF7C, 0xFF7D, 0xFF7E, 0xFF7F,
+    0xFF80, 0xFF81, 0xFF82, 0xFF83, 0xFF84, 0xFF85, 0xFF86, 0xFF87,
+    0xFF88, 0xFF89, 0xFF8A, 0xFF8B, 0xFF8C, 0xFF8D, 0xFF8E, 0xFF8F,
+    0xFF90, 0xFF91, 0xFF92, 0xFF93, 0xFF94, 0xFF95, 0xFF96, 0xFF97,
+    0xFF98, 0xFF99, 0xFF9A, 0xFF9B, 0xFF9C, 0xFF9D, 0xFF9E, 0xFF9F,
+    0xFFA0, 0xFFA1, 0xFFA2, 0xFFA3, 0xFFA4, 0xFFA5, 0xFFA6, 0xFFA7,
+    0xFFA8, 0xFFA9, 0xFFAA, 0xFFAB, 0xFFAC, 0xFFAD, 0xFFAE, 0xFFAF,
+    0xFFB0, 0xFFB1, 0xFFB2, 0xFFB3, 0xFFB4, 0xFFB5, 0xFFB6, 0xFFB7,
+    0xFFB8, 0xFFB9, 0xFFBA, 0xFFBB, 0xFFBC, 0xFFBD, 0xFFBE, 0xFFBF,
+    0xFFC0, 0xFFC1, 0xFFC2, 0xFFC3, 0xFFC4, 0xFFC5, 0xFFC6, 0xFFC7,
+    0xFFC8, 0xFFC9, 0xFFCA, 0xFFCB, 0xFFCC, 0xFFCD, 0xFFCE, 0xFFCF,
+    0xFFD0, 0xFFD1, 0xFFD2, 0xFFD3, 0xFFD4, 0xFFD5, 0xFFD6, 0xFFD7,
+    0xFFD8, 0xFFD9, 0xFFDA, 0xFFDB, 0xFFDC, 0xFFDD, 0xFFDE, 0xFFDF,
+    0x00A2, 0x00A3, 0x00AC, 0x00AF, 0x00A6, 0x00A5, 0x20A9, 0xFFE7,
+    0xFFE8, 0xFFE9, 0xFFEA, 0xFFEB, 0xFFEC, 0xFFED, 0xFFEE,
+};
+
+static const gunichar
+full_half_rest_table[][3] = {
+    { 0x2190, 0xFFE9, 4 },
+    { 0x25A0, 0xFFED, 1 },
+    { 0x25CB, 0xFFEE, 1 },
+};
+
+/* utf8 encoding of the full width form of printable ascii 0x20 - 0x7E */
+static const gchar
+half_full_ascii_utf8[0x7F - 0x20][4] = {
+    "\xE3\x80\x80",    // 0x20
+    "\xEF\xBC\x81",    // 0x21
+    "\xEF\xBC\x82",    // 0x22
+    "\xEF\xBC\x83",    // 0x23
+    "\xEF\xBC\x84",    // 0x24
+    "\xEF\xBC\x85",    // 0x25
+    "\xEF\xBC\x86",    // 0x26
+    "\xEF\xBC\x87",    // 0x27
+    "\xEF\xBC\x88",    // 0x28
+    "\xEF\xBC\x89",    // 0x29
+    "\xEF\xBC\x8A",    // 0x2A
+    "\xEF\xBC\x8B",    // 0x2B
+    "\xEF\xBC\x8C",    // 0x2C
+    "\xEF\xBC\x8D",    // 0x2D
+    "\xEF\xBC\x8E",    // 0x2E
+    "\xEF\xBC\x8F",    // 0x2F
+    "\xEF\xBC\x90",    // 0x30
+    "\xEF\xBC\x91",    // 0x31
+    "\xEF\xBC\x92",    // 0x32
+    "\xEF\xBC\x93",    // 0x33
+    "\xEF\xBC\x94",    // 0x34
+    "\xEF\xBC\x95",    // 0x35
+    "\xEF\xBC\x96",    // 0x36
+    "\xEF\xBC\x97",    // 0x37
+    "\xEF\xBC\x98",    // 0x38
+    "\xEF\xBC\x99",    // 0x39
+    "\xEF\xBC\x9A",    // 0x3A
+    "\xEF\xBC\x9B",    // 0x3B
+    "\xEF\xBC\x9C",    // 0x3C
+    "\xEF\xBC\x9D",    // 0x3D
+    "\xEF\xBC\x9E",    // 0x3E
+    "\xEF\xBC\x9F",    // 0x3F
+    "\xEF\xBC\xA0",    // 0x40
+    "\xEF\xBC\xA1",    // 0x41
+    "\xEF\xBC\xA2",    // 0x42
+    "\xEF\xBC\xA3",    // 0x43
+    "\xEF\xBC\xA4",    // 0x44
+    "\xEF\xBC\xA5",    // 0x45
+    "\xEF\xBC\xA6",    // 0x46
+    "\xEF\xBC\xA7",    // 0x47
+    "\xEF\xBC\xA8",    // 0x48
+    "\xEF\xBC\xA9",    // 0x49
+    "\xEF\xBC\xAA",    // 0x4A
+    "\xEF\xBC\xAB",    // 0x4B
+    "\xEF\xBC\xAC",    // 0x4C
+    "\xEF\xBC\xAD",    // 0x4D
+    "\xEF\xBC\xAE",    // 0x4E
+    "\xEF\xBC\xAF",    // 0x4F
+    "\xEF\xBC\xB0",    // 0x50
+    "\xEF\xBC\xB1",    // 0x51
+    "\xEF\xBC\xB2",    // 0x52
+    "\xEF\xBC\xB3",    // 0x53
+    "\xEF\xBC\xB4",    // 0x54
+    "\xEF\xBC\xB5",    // 0x55
+    "\xEF\xBC\xB6",    // 0x56
+    "\xEF\xBC\xB7",    // 0x57
+    "\xEF\xBC\xB8",    // 0x58
+    "\xEF\xBC\xB9",    // 0x59
+    "\xEF\xBC\xBA",    // 0x5A
+    "\xEF\xBC\xBB",    // 0x5B
+    "\xEF\xBC\xBC",    // 0x5C
+    "\xEF\xBC\xBD",    // 0x5D
+    "\xEF\xBC\xBE",    // 0x5E
+    "\xEF\xBC\xBF",    // 0x5F
+    "\xEF\xBD\x80",    // 0x60
+    "\xEF\xBD\x81",    // 0x61
+    "\xEF\xBD\x82",    // 0x62
+    "\xEF\xBD\x83",    // 0x63
+    "\xEF\xBD\x84",    // 0x64
+    "\xEF\xBD\x85",    // 0x65
+    "\xEF\xBD\x86",    // 0x66
+    "\xEF\xBD\x87",    // 0x67
+    "\xEF\xBD\x88",    // 0x68
+    "\xEF\xBD\x89",    // 0x69
+    "\xEF\xBD\x8A",    // 0x6A
+    "\xEF\xBD\x8B",    // 0x6B
+    "\xEF\xBD\x8C",    // 0x6C
+    "\xEF\xBD\x8D",    // 0x6D
+    "\xEF\xBD\x8E",    // 0x6E
+    "\xEF\xBD\x8F",    // 0x6F
+    "\xEF\xBD\x90",    // 0x70
+    "\xEF\xBD\x91",    // 0x71
+    "\xEF\xBD\x92",    // 0x72
+    "\xEF\xBD\x93",    // 0x73
+    "\xEF\xBD\x94",    // 0x74
+    "\xEF\xBD\x95",    // 0x75
+    "\xEF\xBD\x96",    // 0x76
+    "\xEF\xBD\x97",    // 0x77
+    "\xEF\xBD\x98",    // 0x78
+    "\xEF\xBD\x99",    // 0x79
+    "\xEF\xBD\x9A",    // 0x7A
+    "\xEF\xBD\x9B",    // 0x7B
+    "\xEF\xBD\x9C",    // 0x7C
+    "\xEF\xBD\x9D",    // 0x7D
+    "\xEF\xBD\x9E",    // 0x7E
+};
+
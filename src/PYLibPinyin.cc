@@ -21,11 +21,20 @@
 
 #include "PYLibPinyin.h"
 
+#include <errno.h>
+#include <stdio.h>
 #include <string.h>
+#include <unistd.h>
+#include <glib/gstdio.h>
 #include <pinyin.h>
 #include "PYPConfig.h"
+#include "PYWorker.h"
 
 #define LIBPINYIN_SAVE_TIMEOUT   (5 * 60)
+#define LIBPINYIN_MAX_USER_INPUTS   256
+#define LIBPINYIN_EXPORT_PHRASES    512
+#define LIBPINYIN_EXPORT_CHUNK_SIZE (64 * 1024)
+#define LIBPINYIN_CLEAR_SAVE_DELAY  100
 
 using namespace PY;
 
@@ -38,14 +47,33 @@ LibPinyinBackEnd::LibPinyinBackEnd () {
     m_timer = g_timer_new ();
     m_pinyin_context = NULL;
     m_chewing_context = NULL;
+    m_pinyin_options = 0;
+    m_pinyin_scheme = DOUBLE_PINYIN_DEFAULT;
+    m_chewing_options = 0;
+    m_chewing_scheme = CHEWING_DEFAULT;
+    m_export = NULL;
+    m_export_id = 0;
+    m_clear_id = 0;
+    m_pinyin_clear = NULL;
+    m_chewing_clear = NULL;
+    m_clear_save_id = 0;
 }
 
 LibPinyinBackEnd::~LibPinyinBackEnd () {
     g_timer_destroy (m_timer);
-    if (m_timeout_id != 0) {
+    finishExport ();
+    if (m_clear_id != 0) {
+        g_source_remove (m_clear_id);
+        m_clear_id = 0;
+        /* clear before the last save, or the data is written back. */
+        runClear (FALSE);
+    }
+    if (m_timeout_id != 0 || m_clear_save_id != 0)
         saveUserDB ();
+    if (m_timeout_id != 0)
         g_source_remove (m_timeout_id);
-    }
+    if (m_clear_save_id != 0)
+        g_source_remove (m_clear_save_id);
 
     if (m_pinyin_context)
         pinyin_fini(m_pinyin_context);
@@ -55,13 +83,15 @@ LibPinyinBackEnd::~LibPinyinBackEnd () {
     m_chewing_context = NULL;
 }
 
-pinyin_context_t *
-LibPinyinBackEnd::initPinyinContext (Config *config)
+/* load the context with the user data in the user cache dir name,
+ * only reads its arguments, so the worker could load one too. */
+static pinyin_context_t *
+loadContext (const char *name, const char *dicts)
 {
     pinyin_context_t * context = NULL;
 
     gchar * userdir = g_build_filename (g_get_user_cache_dir (),
-                                        "ibus", "libpinyin", NULL);
+                                        "ibus", name, NULL);
     int retval = g_mkdir_with_parents (userdir, 0700);
     if (retval) {
         g_free (userdir); userdir = NULL;
@@ -69,7 +99,6 @@ LibPinyinBackEnd::initPinyinContext (Config *config)
     context = pinyin_init (LIBPINYIN_DATADIR, userdir);
     g_free (userdir);
 
-    const char *dicts = config->dictionaries ().c_str ();
     gchar ** indices = g_strsplit_set (dicts, ";", -1);
     for (size_t i = 0; i < g_strv_length(indices); ++i) {
         int index = atoi (indices [i]);
@@ -83,11 +112,19 @@ LibPinyinBackEnd::initPinyinContext (Config *config)
     return context;
 }
 
+pinyin_context_t *
+LibPinyinBackEnd::initPinyinContext (Config *config)
+{
+    return loadContext ("libpinyin", config->dictionaries ().c_str ());
+}
+
 pinyin_instance_t *
 LibPinyinBackEnd::allocPinyinInstance ()
 {
     Config * config = &PinyinConfig::instance ();
     if (NULL == m_pinyin_context) {
+        /* load the user data after the worker cleared it. */
+        waitClear (m_pinyin_clear);
         m_pinyin_context = initPinyinContext (config);
     }
 
@@ -104,29 +141,7 @@ LibPinyinBackEnd::freePinyinInstance (pinyin_instance_t *instance)
 pinyin_context_t *
 LibPinyinBackEnd::initChewingContext (Config *config)
 {
-    pinyin_context_t * context = NULL;
-
-    gchar * userdir = g_build_filename (g_get_user_cache_dir (),
-                                        "ibus", "libbopomofo", NULL);
-    int retval = g_mkdir_with_parents (userdir, 0700);
-    if (retval) {
-        g_free(userdir); userdir = NULL;
-    }
-    context = pinyin_init (LIBPINYIN_DATADIR, userdir);
-    g_free(userdir);
-
-    const char *dicts = config->dictionaries ().c_str ();
-    gchar ** indices = g_strsplit_set (dicts, ";", -1);
-    for (size_t i = 0; i < g_strv_length(indices); ++i) {
-        int index = atoi (indices [i]);
-        if (index <= 1)
-            continue;
-
-        pinyin_load_addon_phrase_library (context, index);
-    }
-    g_strfreev (indices);
-
-    return context;
+    return loadContext ("libbopomofo", config->dictionaries ().c_str ());
 }
 
 pinyin_instance_t *
@@ -134,6 +149,7 @@ LibPinyinBackEnd::allocChewingInstance ()
 {
     Config *config = &BopomofoConfig::instance ();
     if (NULL == m_chewing_context) {
+        waitClear (m_chewing_clear);
         m_chewing_context = initChewingContext (config);
     }
 
@@ -166,11 +182,17 @@ LibPinyinBackEnd::setPinyinOptions (Config *config)
         return FALSE;
 
     DoublePinyinScheme scheme = config->doublePinyinSchema ();
-    pinyin_set_double_pinyin_scheme (m_pinyin_context, scheme);
-
     pinyin_option_t options = config->option()
         | USE_RESPLIT_TABLE | USE_DIVIDED_TABLE;
+
+    /* the options are pushed again only when changed. */
+    if (options == m_pinyin_options && scheme == m_pinyin_scheme)
+        return TRUE;
+
+    pinyin_set_double_pinyin_scheme (m_pinyin_context, scheme);
     pinyin_set_options (m_pinyin_context, options);
+    m_pinyin_scheme = scheme;
+    m_pinyin_options = options;
     return TRUE;
 }
 
@@ -181,10 +203,15 @@ LibPinyinBackEnd::setChewingOptions (Config *config)
         return FALSE;
 
     ChewingScheme scheme = config->bopomofoKeyboardMapping ();
-    pinyin_set_chewing_scheme (m_chewing_context, scheme);
-
     pinyin_option_t options = config->option() | USE_TONE;
+
+    if (options == m_chewing_options && scheme == m_chewing_scheme)
+        return TRUE;
+
+    pinyin_set_chewing_scheme (m_chewing_context, scheme);
     pinyin_set_options(m_chewing_context, options);
+    m_chewing_scheme = scheme;
+    m_chewing_options = options;
     return TRUE;
 }
 
@@ -205,6 +232,9 @@ LibPinyinBackEnd::modified (void)
 gboolean
 LibPinyinBackEnd::importPinyinDictionary (const char * filename)
 {
+    /* the phrases can not be added while exporting. */
+    finishExport ();
+
     /* user phrase library should be already loaded here. */
     FILE * dictfile = fopen (filename, "r");
     if (NULL == dictfile)
@@ -250,108 +280,481 @@ LibPinyinBackEnd::importPinyinDictionary (const char * filename)
     return TRUE;
 }
 
+namespace PY {
+struct DictionaryExport {
+    gchar *filename;
+
+    /* used from main loop. */
+    export_iterator_t *iter;
+    GString *contents;
+    guint phrases;
+
+    /* used by the worker, the chunks are written to a temporary file
+       which is renamed to filename after the last chunk. */
+    gchar *tmpname;
+    FILE *file;
+    GError *error;
+};
+
+struct DictionaryExportChunk {
+    DictionaryExport *dictionary;
+    GString *contents;
+    gboolean last;
+};
+};
+
 gboolean
 LibPinyinBackEnd::exportPinyinDictionary (const char * filename)
 {
-    /* user phrase library should be already loaded here. */
-    FILE * dictfile = fopen (filename, "w");
-    if (NULL == dictfile)
+    if (m_export != NULL) {
+        PinyinConfig::instance ().setValue (CONFIG_EXPORT_DICTIONARY_RESULT,
+            g_variant_new_string ("Another export is still running."));
         return FALSE;
+    }
+
+    /* user phrase library should be already loaded here. */
+    flushUserInputs ();
 
     export_iterator_t * iter = pinyin_begin_get_phrases
         (m_pinyin_context, USER_DICTIONARY);
 
-    if (NULL == iter)
+    if (NULL == iter) {
+        PinyinConfig::instance ().setValue (CONFIG_EXPORT_DICTIONARY_RESULT,
+            g_variant_new_string ("Can not read the user dictionary."));
         return FALSE;
+    }
+
+    /* walk the phrases in chunks from main loop,
+       the file is written by the worker. */
+    m_export = new DictionaryExport;
+    m_export->filename = g_strdup (filename);
+    m_export->iter = iter;
+    m_export->contents = g_string_sized_new (LIBPINYIN_EXPORT_CHUNK_SIZE);
+    m_export->phrases = 0;
+    m_export->tmpname = NULL;
+    m_export->file = NULL;
+    m_export->error = NULL;
+    m_export_id = g_idle_add (exportCallback, this);
+    return TRUE;
+}
+
+/* format at most max_phrases phrases, FALSE when all are formatted. */
+gboolean
+LibPinyinBackEnd::exportPhrases (guint max_phrases)
+{
+    export_iterator_t *iter = m_export->iter;
+    GString *contents = m_export->contents;
 
     /* use " " as the separator. */
-    while (pinyin_iterator_has_next_phrase (iter)) {
+    for (guint i = 0; i < max_phrases; i++) {
+        if (!pinyin_iterator_has_next_phrase (iter))
+            break;
+
         gchar * phrase = NULL; gchar * pinyin = NULL;
         gint count = -1;
 
         g_assert (pinyin_iterator_get_next_phrase (iter, &phrase, &pinyin, &count));
 
-        if (-1 == count) /* skip output the default count. */
-            fprintf (dictfile, "%s %s\n", phrase, pinyin);
-        else /* output the count. */
-            fprintf (dictfile, "%s %s %d\n", phrase, pinyin, count);
+        g_string_append (contents, phrase);
+        g_string_append_c (contents, ' ');
+        g_string_append (contents, pinyin);
+        if (-1 != count) /* skip output the default count. */
+            g_string_append_printf (contents, " %d", count);
+        g_string_append_c (contents, '\n');
 
         g_free (phrase); g_free (pinyin);
+        m_export->phrases++;
+
+        if (contents->len >= LIBPINYIN_EXPORT_CHUNK_SIZE) {
+            pushExportChunk (FALSE);
+            contents = m_export->contents;
+        }
     }
 
-    fclose (dictfile);
-    return TRUE;
+    if (pinyin_iterator_has_next_phrase (iter))
+        return TRUE;
+
+    pinyin_end_get_phrases (iter);
+    m_export->iter = NULL;
+    pushExportChunk (TRUE);
+    m_export = NULL;
+    return FALSE;
+}
+
+/* hand the formatted phrases to the worker, and publish the progress. */
+void
+LibPinyinBackEnd::pushExportChunk (gboolean last)
+{
+    DictionaryExportChunk *chunk = new DictionaryExportChunk;
+    chunk->dictionary = m_export;
+    chunk->contents = m_export->contents;
+    chunk->last = last;
+    Worker::instance ().push (exportJob, last ? exportDone : NULL,
+                              exportFree, chunk);
+
+    if (last) {
+        m_export->contents = NULL;
+        return;
+    }
+
+    m_export->contents = g_string_sized_new (LIBPINYIN_EXPORT_CHUNK_SIZE);
+    /* the setup dialog shows the number of the exported phrases. */
+    PinyinConfig::instance ().setValue (CONFIG_EXPORT_DICTIONARY_RESULT,
+                                        g_variant_new_uint32 (m_export->phrases));
+}
+
+/* complete the walk now, before the user phrases are changed. */
+void
+LibPinyinBackEnd::finishExport (void)
+{
+    if (m_export == NULL)
+        return;
+
+    g_source_remove (m_export_id);
+    m_export_id = 0;
+    exportPhrases (G_MAXUINT);
+}
+
+gboolean
+LibPinyinBackEnd::exportCallback (gpointer data)
+{
+    LibPinyinBackEnd *self = static_cast<LibPinyinBackEnd *> (data);
+
+    if (self->exportPhrases (LIBPINYIN_EXPORT_PHRASES))
+        return TRUE;
+    self->m_export_id = 0;
+    return FALSE;
+}
+
+static void
+set_export_error (GError **error, const gchar *filename)
+{
+    int saved_errno = errno;
+    g_set_error (error, G_FILE_ERROR, g_file_error_from_errno (saved_errno),
+                 "%s: %s", filename, g_strerror (saved_errno));
+}
+
+void
+LibPinyinBackEnd::exportJob (gpointer data)
+{
+    DictionaryExportChunk *chunk = static_cast<DictionaryExportChunk *> (data);
+    DictionaryExport *dictionary = chunk->dictionary;
+
+    /* the chunks after an error are dropped. */
+    if (dictionary->error == NULL && dictionary->file == NULL) {
+        dictionary->tmpname = g_strconcat (dictionary->filename,
+                                           ".XXXXXX", NULL);
+        int fd = g_mkstemp (dictionary->tmpname);
+        if (fd == -1 || (dictionary->file = fdopen (fd, "w")) == NULL) {
+            set_export_error (&dictionary->error, dictionary->tmpname);
+            if (fd != -1) {
+                close (fd);
+                g_unlink (dictionary->tmpname);
+            }
+        }
+    }
+
+    if (dictionary->error == NULL && chunk->contents->len > 0 &&
+        fwrite (chunk->contents->str, 1, chunk->contents->len,
+                dictionary->file) != chunk->contents->len)
+        set_export_error (&dictionary->error, dictionary->tmpname);
+
+    if (!chunk->last || dictionary->file == NULL)
+        return;
+
+    if (fclose (dictionary->file) != 0 && dictionary->error == NULL)
+        set_export_error (&dictionary->error, dictionary->tmpname);
+    dictionary->file = NULL;
+
+    if (dictionary->error == NULL &&
+        g_rename (dictionary->tmpname, dictionary->filename) != 0)
+        set_export_error (&dictionary->error, dictionary->filename);
+    if (dictionary->error)
+        g_unlink (dictionary->tmpname);
+}
+
+void
+LibPinyinBackEnd::exportDone (gpointer data)
+{
+    DictionaryExportChunk *chunk = static_cast<DictionaryExportChunk *> (data);
+    DictionaryExport *dictionary = chunk->dictionary;
+
+    /* the setup dialog watches the result, "" means success. */
+    const gchar *message = "";
+    if (dictionary->error) {
+        g_warning ("Can not export dictionary: %s",
+                   dictionary->error->message);
+        message = dictionary->error->message;
+    }
+    PinyinConfig::instance ().setValue (CONFIG_EXPORT_DICTIONARY_RESULT,
+                                        g_variant_new_string (message));
+}
+
+void
+LibPinyinBackEnd::exportFree (gpointer data)
+{
+    DictionaryExportChunk *chunk = static_cast<DictionaryExportChunk *> (data);
+    DictionaryExport *dictionary = chunk->dictionary;
+
+    g_string_free (chunk->contents, TRUE);
+    if (chunk->last) {
+        if (dictionary->error)
+            g_error_free (dictionary->error);
+        g_free (dictionary->tmpname);
+        g_free (dictionary->filename);
+        delete dictionary;
+    }
+    delete chunk;
 }
 
 gboolean
 LibPinyinBackEnd::clearPinyinUserData (const char * target)
+{
+    if (0 != strcmp ("all", target) && 0 != strcmp ("user", target)) {
+        g_warning ("unknown clear target: %s.\n", target);
+        return FALSE;
+    }
+
+    /* clear from main loop later, the config callback returns at once,
+       keep the broader target of the pending clears. */
+    if (m_clear_id == 0 || m_clear_target != "all")
+        m_clear_target = target;
+    if (m_clear_id == 0)
+        m_clear_id = g_idle_add (clearCallback, this);
+    return TRUE;
+}
+
+namespace PY {
+struct UserDataClear {
+    UserDataClear (const char *name, const std::string &dictionaries,
+                   const std::string &target)
+        : name (name), dictionaries (dictionaries), target (target),
+          finished (FALSE)
+    {
+        g_mutex_init (&mutex);
+        g_cond_init (&cond);
+    }
+
+    ~UserDataClear ()
+    {
+        g_cond_clear (&cond);
+        g_mutex_clear (&mutex);
+    }
+
+    const char *name;
+    std::string dictionaries;
+    std::string target;
+
+    /* finished is set by the worker. */
+    GMutex mutex;
+    GCond cond;
+    gboolean finished;
+};
+};
+
+gboolean
+LibPinyinBackEnd::clearCallback (gpointer data)
+{
+    LibPinyinBackEnd *self = static_cast<LibPinyinBackEnd *> (data);
+    self->m_clear_id = 0;
+    self->runClear (TRUE);
+    return FALSE;
+}
+
+gboolean
+LibPinyinBackEnd::clearSaveCallback (gpointer data)
+{
+    LibPinyinBackEnd *self = static_cast<LibPinyinBackEnd *> (data);
+    self->m_clear_save_id = 0;
+    self->saveUserDB ();
+    return FALSE;
+}
+
+void
+LibPinyinBackEnd::runClear (gboolean background)
+{
+    /* the phrases can not be masked out while exporting. */
+    finishExport ();
+
+    m_pinyin_inputs.clear ();
+    m_chewing_inputs.clear ();
+
+    clearContext (m_pinyin_context, "libpinyin",
+                  PinyinConfig::instance ().dictionaries (),
+                  &m_pinyin_clear, background);
+    clearContext (m_chewing_context, "libbopomofo",
+                  BopomofoConfig::instance ().dictionaries (),
+                  &m_chewing_clear, background);
+}
+
+void
+LibPinyinBackEnd::clearContext (pinyin_context_t *context, const char *name,
+                                const std::string &dictionaries,
+                                UserDataClear **pending, gboolean background)
+{
+    /* a loaded context is only used from main loop. */
+    if (context) {
+        clearUserData (context, m_clear_target.c_str ());
+        /* save soon in another main loop iteration, the autosave
+           waits until the typing stops. */
+        if (m_clear_save_id == 0)
+            m_clear_save_id = g_timeout_add (LIBPINYIN_CLEAR_SAVE_DELAY,
+                                             clearSaveCallback, this);
+        return;
+    }
+
+    /* the user data on disk is only cleared with a loaded context,
+       the worker loads a private one. */
+    UserDataClear *clear = new UserDataClear (name, dictionaries, m_clear_target);
+    if (background) {
+        *pending = clear;
+        Worker::instance ().push (clearJob, clearDone, clearFree, clear);
+        return;
+    }
+
+    waitClear (*pending);
+    clearJob (clear);
+    delete clear;
+}
+
+void
+LibPinyinBackEnd::clearJob (gpointer data)
+{
+    UserDataClear *clear = static_cast<UserDataClear *> (data);
+
+    pinyin_context_t *context =
+        loadContext (clear->name, clear->dictionaries.c_str ());
+    clearUserData (context, clear->target.c_str ());
+    pinyin_save (context);
+    pinyin_fini (context);
+
+    g_mutex_lock (&clear->mutex);
+    clear->finished = TRUE;
+    g_cond_signal (&clear->cond);
+    g_mutex_unlock (&clear->mutex);
+}
+
+void
+LibPinyinBackEnd::clearDone (gpointer data)
+{
+    UserDataClear *clear = static_cast<UserDataClear *> (data);
+    LibPinyinBackEnd &self = instance ();
+
+    if (self.m_pinyin_clear == clear)
+        self.m_pinyin_clear = NULL;
+    if (self.m_chewing_clear == clear)
+        self.m_chewing_clear = NULL;
+}
+
+void
+LibPinyinBackEnd::clearFree (gpointer data)
+{
+    delete static_cast<UserDataClear *> (data);
+}
+
+void
+LibPinyinBackEnd::waitClear (UserDataClear *clear)
+{
+    if (clear == NULL)
+        return;
+
+    g_mutex_lock (&clear->mutex);
+    while (!clear->finished)
+        g_cond_wait (&clear->cond, &clear->mutex);
+    g_mutex_unlock (&clear->mutex);
+}
+
+void
+LibPinyinBackEnd::clearUserData (pinyin_context_t *context,
+                                 const char *target)
 {
     if (0 == strcmp ("all", target)) {
-        pinyin_mask_out (m_pinyin_context, 0x0, 0x0);
+        pinyin_mask_out (context, 0x0, 0x0);
     } else if (0 == strcmp ("user", target)) {
         /* clear addon dictionary. */
-        pinyin_mask_out (m_pinyin_context, PHRASE_INDEX_LIBRARY_MASK,
+        pinyin_mask_out (context, PHRASE_INDEX_LIBRARY_MASK,
                          PHRASE_INDEX_MAKE_TOKEN (ADDON_DICTIONARY, null_token));
         /* clear user dictionary. */
-        pinyin_mask_out (m_pinyin_context, PHRASE_INDEX_LIBRARY_MASK,
-                        PHRASE_INDEX_MAKE_TOKEN (USER_DICTIONARY, null_token));
-    } else {
-        g_warning ("unknown clear target: %s.\n", target);
+        pinyin_mask_out (context, PHRASE_INDEX_LIBRARY_MASK,
+                         PHRASE_INDEX_MAKE_TOKEN (USER_DICTIONARY, null_token));
     }
-
-    pinyin_save (m_pinyin_context);
-    return TRUE;
 }
 
 gboolean
 LibPinyinBackEnd::rememberUserInput (pinyin_instance_t * instance)
 {
-    /* pre-check the incomplete pinyin keys. */
     guint len = 0;
     g_assert (pinyin_get_n_pinyin (instance, &len));
 
     if (0 == len || len >= MAX_PHRASE_LENGTH)
         return FALSE;
 
-    size_t i = 0;
-    for ( ; i < len; ++i) {
+    /* prepare pinyin string, skip the incomplete pinyin keys. */
+    std::string pinyins;
+    for (size_t i = 0; i < len; ++i) {
         PinyinKey *key = NULL;
         g_assert (pinyin_get_pinyin_key (instance, i, &key));
         if (pinyin_get_pinyin_is_incomplete (instance, key))
             return FALSE;
-    }
 
-    /* prepare pinyin string. */
-    GPtrArray *array = g_ptr_array_new ();
-    for (i = 0; i < len; ++i) {
-        PinyinKey *key = NULL;
-        g_assert (pinyin_get_pinyin_key (instance, i, &key));
         gchar * pinyin = NULL;
         g_assert (pinyin_get_pinyin_string (instance, key, &pinyin));
-        g_ptr_array_add (array, pinyin);
+        if (i > 0)
+            pinyins += '\'';
+        pinyins += pinyin;
+        g_free (pinyin);
     }
-    g_ptr_array_add (array, NULL);
-
-    gchar **strings = (gchar **) g_ptr_array_free (array, FALSE);
-    gchar *pinyins = g_strjoinv ("'", strings);
-    g_strfreev (strings);
 
-    /* remember user input. */
-    import_iterator_t * iter = NULL;
-    pinyin_context_t * context = pinyin_get_context (instance);
-    iter = pinyin_begin_add_phrases (context, USER_DICTIONARY);
     char * phrase = NULL;
     g_assert (pinyin_get_sentence (instance, &phrase));
-    g_assert (pinyin_iterator_add_phrase (iter, phrase, pinyins, -1));
-    pinyin_end_add_phrases (iter);
+
+    /* remember user input in memory, and add them on next save. */
+    UserInputs &inputs =
+        pinyin_get_context (instance) == m_chewing_context ?
+        m_chewing_inputs : m_pinyin_inputs;
+    inputs.insert (UserInputs::value_type (phrase, pinyins));
     g_free (phrase);
-    g_free (pinyins);
+
+    if (inputs.size () >= LIBPINYIN_MAX_USER_INPUTS)
+        flushUserInputs ();
 
     /* save later,
        will mark modified from pinyin/bopomofo editor. */
     return TRUE;
 }
 
+void
+LibPinyinBackEnd::flushUserInputs (pinyin_context_t *context,
+                                   UserInputs &inputs)
+{
+    if (inputs.empty ())
+        return;
+
+    import_iterator_t * iter = NULL;
+    if (context != NULL)
+        iter = pinyin_begin_add_phrases (context, USER_DICTIONARY);
+
+    if (iter != NULL) {
+        UserInputs::const_iterator it;
+        for (it = inputs.begin (); it != inputs.end (); ++it)
+            pinyin_iterator_add_phrase (iter, it->first.c_str (),
+                                        it->second.c_str (), -1);
+        pinyin_end_add_phrases (iter);
+    }
+    inputs.clear ();
+}
+
+void
+LibPinyinBackEnd::flushUserInputs (void)
+{
+    /* keep the inputs until the export walk is done. */
+    if (m_export != NULL)
+        return;
+
+    flushUserInputs (m_pinyin_context, m_pinyin_inputs);
+    flushUserInputs (m_chewing_context, m_chewing_inputs);
+}
+
 gboolean
 LibPinyinBackEnd::timeoutCallback (gpointer data)
 {
@@ -372,6 +775,7 @@ LibPinyinBackEnd::timeoutCallback (gpointer data)
 gboolean
 LibPinyinBackEnd::saveUserDB (void)
 {
+    flushUserInputs ();
     if (m_pinyin_context)
         pinyin_save (m_pinyin_context);
     if (m_chewing_context)
@@ -23,14 +23,17 @@
 #define __PY_LIB_PINYIN_H_
 
 #include <memory>
+#include <set>
+#include <string>
 #include <glib.h>
-
-typedef struct _pinyin_context_t pinyin_context_t;
-typedef struct _pinyin_instance_t pinyin_instance_t;
+#include <pinyin.h>
 
 namespace PY {
 
 class Config;
+struct DictionaryExport;
+struct DictionaryExportChunk;
+struct UserDataClear;
 
 class LibPinyinBackEnd{
 
@@ -64,14 +67,59 @@ public:
 
 
 private:
+    /* phrase and pinyin string of the remembered user inputs. */
+    typedef std::set<std::pair<std::string, std::string> > UserInputs;
+
     gboolean saveUserDB (void);
+    void flushUserInputs (void);
+    void flushUserInputs (pinyin_context_t *context, UserInputs &inputs);
     static gboolean timeoutCallback (gpointer data);
+    gboolean exportPhrases (guint max_phrases);
+    void pushExportChunk (gboolean last);
+    void finishExport (void);
+    static gboolean exportCallback (gpointer data);
+    static void exportJob (gpointer data);
+    static void exportDone (gpointer data);
+    static void exportFree (gpointer data);
+    void runClear (gboolean background);
+    void clearContext (pinyin_context_t *context, const char *name,
+                       const std::string &dictionaries,
+                       UserDataClear **pending, gboolean background);
+    static gboolean clearCallback (gpointer data);
+    static gboolean clearSaveCallback (gpointer data);
+    static void clearJob (gpointer data);
+    static void clearDone (gpointer data);
+    static void clearFree (gpointer data);
+    static void waitClear (UserDataClear *clear);
+    static void clearUserData (pinyin_context_t *context, const char *target);
 
 private:
     /* libpinyin context */
     pinyin_context_t *m_pinyin_context;
     pinyin_context_t *m_chewing_context;
 
+    /* options last pushed to the contexts, 0 before the first push,
+     * the pushed options always have USE_RESPLIT_TABLE or USE_TONE. */
+    pinyin_option_t m_pinyin_options;
+    DoublePinyinScheme m_pinyin_scheme;
+    pinyin_option_t m_chewing_options;
+    ChewingScheme m_chewing_scheme;
+
+    UserInputs m_pinyin_inputs;
+    UserInputs m_chewing_inputs;
+
+    /* the export walking the user phrases over idle iterations. */
+    DictionaryExport *m_export;
+    guint m_export_id;
+
+    guint m_clear_id;
+    std::string m_clear_target;
+    /* the last clear of a context not loaded, run by the worker. */
+    UserDataClear *m_pinyin_clear;
+    UserDataClear *m_chewing_clear;
+    /* the save after a clear of a loaded context. */
+    guint m_clear_save_id;
+
     guint m_timeout_id;
     GTimer *m_timer;
 
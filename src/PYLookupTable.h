@@ -33,10 +33,22 @@ public:
                  guint cursor_pos = 0,
                  gboolean cursor_visible = TRUE,
                  gboolean round = FALSE)
-        : Object (ibus_lookup_table_new (page_size, cursor_pos, cursor_visible, round)) { }
+        : Object (ibus_lookup_table_new (page_size, cursor_pos, cursor_visible, round)),
+          m_page_size (page_size),
+          m_orientation (ibus_lookup_table_get_orientation (*this)),
+          m_label_set (LABEL_SET_NONE) { }
 
-    guint pageSize (void)       { return ibus_lookup_table_get_page_size (*this); }
-    guint orientation (void)    { return ibus_lookup_table_get_orientation (*this); }
+    /* label sets shared by all lookup tables. */
+    enum LabelSet {
+        LABEL_SET_NONE = -1,
+        LABEL_SET_DIGIT,
+        LABEL_SET_ALPHA,
+        LABEL_SET_EMPTY,
+        LABEL_SET_LAST,
+    };
+
+    guint pageSize (void)       { return m_page_size; }
+    guint orientation (void)    { return m_orientation; }
     guint cursorPos (void)      { return ibus_lookup_table_get_cursor_pos (*this); }
     guint size (void)           { return ibus_lookup_table_get_number_of_candidates (*this); }
 
@@ -45,21 +57,94 @@ public:
     gboolean cursorUp (void)    { return ibus_lookup_table_cursor_up (*this); }
     gboolean cursorDown (void)  { return ibus_lookup_table_cursor_down (*this); }
 
-    void setPageSize (guint size)           { ibus_lookup_table_set_page_size (*this, size); }
     void setCursorPos (guint pos)           { ibus_lookup_table_set_cursor_pos (*this, pos); }
-    void setOrientation (gint orientation)  { ibus_lookup_table_set_orientation (*this, orientation); }
     void clear (void)                       { ibus_lookup_table_clear (*this); }
     void setCursorVisable (gboolean visable){ ibus_lookup_table_set_cursor_visible (*this, visable); }
-    void setLabel (guint index, IBusText *text) { ibus_lookup_table_set_label (*this, index, text); }
     void appendCandidate (IBusText *text)   { ibus_lookup_table_append_candidate (*this, text); }
-    void appendLabel (IBusText *text)       { ibus_lookup_table_append_label (*this, text); }
+
+    void setPageSize (guint size)
+    {
+        if (G_LIKELY (size == m_page_size))
+            return;
+        m_page_size = size;
+        ibus_lookup_table_set_page_size (*this, size);
+    }
+
+    void setOrientation (gint orientation)
+    {
+        if (G_LIKELY ((guint) orientation == m_orientation))
+            return;
+        m_orientation = orientation;
+        ibus_lookup_table_set_orientation (*this, orientation);
+    }
+
+    void setLabel (guint index, IBusText *text)
+    {
+        m_label_set = LABEL_SET_NONE;
+        ibus_lookup_table_set_label (*this, index, text);
+    }
+
+    void appendLabel (IBusText *text)
+    {
+        m_label_set = LABEL_SET_NONE;
+        ibus_lookup_table_append_label (*this, text);
+    }
+
+    void setLabels (LabelSet label_set)
+    {
+        if (label_set == m_label_set)
+            return;
+        m_label_set = label_set;
+
+        IBusText **labels = getLabelSet (label_set);
+        for (guint i = 0; i < LABEL_SET_SIZE; i++)
+            ibus_lookup_table_set_label (*this, i, labels[i]);
+    }
     IBusText * getCandidate(guint index)    { return ibus_lookup_table_get_candidate(*this, index); }
 
+    void setCandidate (guint index, IBusText *text)
+    {
+        IBusLookupTable *table = *this;
+        IBusText *&candidate = g_array_index (table->candidates, IBusText *, index);
+        g_object_unref (candidate);
+        candidate = (IBusText *) g_object_ref_sink (text);
+    }
+
     operator IBusLookupTable * (void) const
     {
         return get<IBusLookupTable> ();
     }
 
+private:
+    static const guint LABEL_SET_SIZE = 10;
+
+    static IBusText ** getLabelSet (LabelSet label_set)
+    {
+        static IBusText *label_sets[LABEL_SET_LAST][LABEL_SET_SIZE];
+        static const gchar digits[] = "1234567890";
+        static const gchar alphas[] = "abcdefghij";
+
+        IBusText **labels = label_sets[label_set];
+        if (G_UNLIKELY (labels[0] == NULL)) {
+            /* build once, and keep them for the process lifetime. */
+            for (guint i = 0; i < LABEL_SET_SIZE; i++) {
+                IBusText *text;
+                if (label_set == LABEL_SET_DIGIT)
+                    text = ibus_text_new_from_unichar (digits[i]);
+                else if (label_set == LABEL_SET_ALPHA)
+                    text = ibus_text_new_from_unichar (alphas[i]);
+                else
+                    text = ibus_text_new_from_static_string ("");
+                labels[i] = (IBusText *) g_object_ref_sink (text);
+            }
+        }
+        return labels;
+    }
+
+private:
+    guint m_page_size;
+    guint m_orientation;
+    LabelSet m_label_set;
 };
 
 };
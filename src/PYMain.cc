@@ -31,6 +31,9 @@
 #include "PYConfig.h"
 #include "PYPConfig.h"
 #include "PYLibPinyin.h"
+#include "PYSpecialPhraseTable.h"
+#include "PYStats.h"
+#include "PYWorker.h"
 
 using namespace PY;
 
@@ -86,7 +89,10 @@ start_component (void)
         exit (0);
     }
 
+    Stats::setEnabled (verbose);
+    Worker::init ();
     LibPinyinBackEnd::init ();
+    SpecialPhraseTable::init ();
 
     PinyinConfig::init (bus);
     BopomofoConfig::init (bus);
@@ -155,6 +161,8 @@ static void
 atexit_cb (void)
 {
     LibPinyinBackEnd::finalize ();
+    SpecialPhraseTable::finalize ();
+    Worker::finalize ();
 }
 
 int
@@ -54,6 +54,12 @@ BopomofoEditor::~BopomofoEditor (void)
     m_instance = NULL;
 }
 
+gboolean
+BopomofoEditor::formatKeyString (PinyinKey *key, gchar **str)
+{
+    return pinyin_get_chewing_string (m_instance, key, str);
+}
+
 void
 BopomofoEditor::reset (void)
 {
@@ -237,6 +243,8 @@ BopomofoEditor::processKeyEvent (guint keyval, guint keycode,
 void
 BopomofoEditor::updatePinyin (void)
 {
+    invalidateCandidates ();
+
     if (G_UNLIKELY (m_text.empty ())) {
         m_pinyin_len = 0;
         /* TODO: check whether to replace "" with NULL. */
@@ -286,10 +294,12 @@ BopomofoEditor::commit ()
         ++p;
     }
 
-    pinyin_train(m_instance);
-    if (m_config.rememberEveryInput ())
-        LibPinyinBackEnd::instance ().rememberUserInput (m_instance);
-    LibPinyinBackEnd::instance ().modified();
+    if (m_learning) {
+        pinyin_train(m_instance);
+        if (m_config.rememberEveryInput ())
+            LibPinyinBackEnd::instance ().rememberUserInput (m_instance);
+        LibPinyinBackEnd::instance ().modified();
+    }
     PhoneticEditor::commit ((const gchar *)m_buffer);
     reset();
 }
@@ -320,9 +330,8 @@ BopomofoEditor::updatePreeditText ()
     const gchar *p = m_text.c_str () + m_pinyin_len;
     m_buffer << p;
 
-    StaticText preedit_text (m_buffer);
     /* underline */
-    preedit_text.appendAttribute (IBUS_ATTR_TYPE_UNDERLINE, IBUS_ATTR_UNDERLINE_SINGLE, 0, -1);
+    Text preedit_text (m_preedit_text.reset (m_buffer, TRUE));
 
     guint pinyin_cursor = getPinyinCursor ();
     Editor::updatePreeditText (preedit_text, pinyin_cursor, TRUE);
@@ -351,41 +360,26 @@ BopomofoEditor::updateAuxiliaryText (void)
         guint16 cursor = 0, end = 0;
         pinyin_get_pinyin_key_rest_positions (m_instance, pos, &cursor, &end);
 
-        gchar * str = NULL;
         if (G_UNLIKELY (cursor == m_cursor)) { /* at word boundary. */
-            pinyin_get_chewing_string (m_instance, key, &str);
-            m_buffer << '|' << str;
-            g_free (str);
+            m_buffer << '|' << getKeyString (key, pos);
         } else if (G_LIKELY (cursor < m_cursor &&
                              m_cursor < end)) { /* in word */
             /* raw text */
             guint16 length = 0;
             pinyin_get_pinyin_key_rest_length (m_instance, pos, &length);
 
-            String raw = m_text.substr (cursor, length);
-            guint offset = m_cursor - cursor;
             m_buffer << ' ';
-            String before = raw.substr (0, offset);
-            String after = raw.substr (offset);
-            String::const_iterator iter;
             const char * symbol = NULL;
-            for ( iter = before.begin (); iter != before.end (); ++iter) {
-                if ( pinyin_in_chewing_keyboard(m_instance, *iter, &symbol))
-                    m_buffer << symbol;
-                else
-                    m_buffer << *iter;
-            }
-            m_buffer << '|';
-            for ( iter = after.begin (); iter != after.end (); ++iter) {
-                if ( pinyin_in_chewing_keyboard (m_instance, *iter, &symbol))
+            for (guint j = cursor; j < (guint) cursor + length; ++j) {
+                if (j == m_cursor)
+                    m_buffer << '|';
+                if ( pinyin_in_chewing_keyboard (m_instance, m_text[j], &symbol))
                     m_buffer << symbol;
                 else
-                    m_buffer << *iter;
+                    m_buffer << m_text[j];
             }
         } else { /* other words */
-            pinyin_get_chewing_string (m_instance, key, &str);
-            m_buffer << ' ' << str;
-            g_free (str);
+            m_buffer << ' ' << getKeyString (key, pos);
         }
     }
 
@@ -396,7 +390,7 @@ BopomofoEditor::updateAuxiliaryText (void)
     const gchar * p = m_text.c_str() + m_pinyin_len;
     m_buffer << p;
 
-    StaticText aux_text (m_buffer);
+    Text aux_text (m_auxiliary_text.reset (m_buffer));
     Editor::updateAuxiliaryText (aux_text, TRUE);
 }
 
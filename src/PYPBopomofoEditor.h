@@ -50,6 +50,7 @@ protected:
     virtual void updatePreeditText ();
     virtual void updateAuxiliaryText ();
     virtual void updatePinyin (void);
+    virtual gboolean formatKeyString (PinyinKey *key, gchar **str);
 
     void commit ();
     void reset ();
@@ -45,7 +45,7 @@ BopomofoEngine::BopomofoEngine (IBusEngine *engine)
     m_editors[MODE_PUNCT].reset (new PunctEditor (m_props, BopomofoConfig::instance ()));
 
     m_props.signalUpdateProperty ().connect
-        (std::bind (&BopomofoEngine::updateProperty, this, _1));
+        (this, &BopomofoEngine::updateProperty);
 
     for (i = MODE_INIT; i < MODE_LAST; i++) {
         connectEditorSignals (m_editors[i]);
@@ -130,7 +130,9 @@ BopomofoEngine::processKeyEvent (guint keyval, guint keycode, guint modifiers)
 {
     gboolean retval = FALSE;
 
-    if (contentIsPassword ())
+    /* no conversion is wanted in password and latin fields, the keys
+     * go to the application untouched. */
+    if (contentIsPassword () || contentIsLatin ())
         return retval;
 
     if (processAccelKeyEvent (keyval, keycode, modifiers))
@@ -178,6 +180,28 @@ BopomofoEngine::focusOut (void)
     Engine::focusOut ();
 
     reset ();
+    updateLearning ();
+}
+
+#if IBUS_CHECK_VERSION (1, 5, 4)
+void
+BopomofoEngine::setContentType (guint purpose, guint hints)
+{
+    Engine::setContentType (purpose, hints);
+
+    /* latin fields bypass the editors, drop the pending preedit. */
+    if (contentIsLatin ())
+        reset ();
+    updateLearning ();
+}
+#endif
+
+void
+BopomofoEngine::updateLearning (void)
+{
+    gboolean learning = !contentSkipsLearning ();
+    for (gint i = 0; i < MODE_LAST; i++)
+        m_editors[i]->setLearning (learning);
 }
 
 void
@@ -274,31 +298,30 @@ BopomofoEngine::commitText (Text & text)
 void
 BopomofoEngine::connectEditorSignals (EditorPtr editor)
 {
-    editor->signalCommitText ().connect (
-        std::bind (&BopomofoEngine::commitText, this, _1));
+    editor->signalCommitText ().connect (this, &BopomofoEngine::commitText);
 
     editor->signalUpdatePreeditText ().connect (
-        std::bind (&BopomofoEngine::updatePreeditText, this, _1, _2, _3));
+        this, &BopomofoEngine::updatePreeditText);
     editor->signalShowPreeditText ().connect (
-        std::bind (&BopomofoEngine::showPreeditText, this));
+        this, &BopomofoEngine::showPreeditText);
     editor->signalHidePreeditText ().connect (
-        std::bind (&BopomofoEngine::hidePreeditText, this));
+        this, &BopomofoEngine::hidePreeditText);
 
     editor->signalUpdateAuxiliaryText ().connect (
-        std::bind (&BopomofoEngine::updateAuxiliaryText, this, _1, _2));
+        this, &BopomofoEngine::updateAuxiliaryText);
     editor->signalShowAuxiliaryText ().connect (
-        std::bind (&BopomofoEngine::showAuxiliaryText, this));
+        this, &BopomofoEngine::showAuxiliaryText);
     editor->signalHideAuxiliaryText ().connect (
-        std::bind (&BopomofoEngine::hideAuxiliaryText, this));
+        this, &BopomofoEngine::hideAuxiliaryText);
 
     editor->signalUpdateLookupTable ().connect (
-        std::bind (&BopomofoEngine::updateLookupTable, this, _1, _2));
+        this, &BopomofoEngine::updateLookupTable);
     editor->signalUpdateLookupTableFast ().connect (
-        std::bind (&BopomofoEngine::updateLookupTableFast, this, _1, _2));
+        this, &BopomofoEngine::updateLookupTableFast);
     editor->signalShowLookupTable ().connect (
-        std::bind (&BopomofoEngine::showLookupTable, this));
+        this, &BopomofoEngine::showLookupTable);
     editor->signalHideLookupTable ().connect (
-        std::bind (&BopomofoEngine::hideLookupTable, this));
+        this, &BopomofoEngine::hideLookupTable);
 }
 
 
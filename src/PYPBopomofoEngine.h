@@ -39,6 +39,9 @@ public:
     gboolean processKeyEvent (guint keyval, guint keycode, guint modifiers);
     void focusIn (void);
     void focusOut (void);
+#if IBUS_CHECK_VERSION (1, 5, 4)
+    void setContentType (guint purpose, guint hints);
+#endif
     void reset (void);
     void enable (void);
     void disable (void);
@@ -55,6 +58,7 @@ private:
 private:
     void showSetupDialog (void);
     void connectEditorSignals (EditorPtr editor);
+    void updateLearning (void);
 
 private:
     void commitText (Text & text);
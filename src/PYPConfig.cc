@@ -45,6 +45,7 @@ const gchar * const CONFIG_INIT_FULL                 = "InitFull";
 const gchar * const CONFIG_INIT_FULL_PUNCT           = "InitFullPunct";
 const gchar * const CONFIG_INIT_SIMP_CHINESE         = "InitSimplifiedChinese";
 const gchar * const CONFIG_SPECIAL_PHRASES           = "SpecialPhrases";
+const gchar * const CONFIG_LUA_CALL_TIMEOUT          = "LuaCallTimeout";
 const gchar * const CONFIG_DICTIONARIES              = "Dictionaries";
 const gchar * const CONFIG_BOPOMOFO_KEYBOARD_MAPPING = "BopomofoKeyboardMapping";
 const gchar * const CONFIG_SELECT_KEYS               = "SelectKeys";
@@ -54,6 +55,7 @@ const gchar * const CONFIG_AUXILIARY_SELECT_KEY_KP   = "AuxiliarySelectKey_KP";
 const gchar * const CONFIG_ENTER_KEY                 = "EnterKey";
 const gchar * const CONFIG_IMPORT_DICTIONARY         = "ImportDictionary";
 const gchar * const CONFIG_EXPORT_DICTIONARY         = "ExportDictionary";
+const gchar * const CONFIG_EXPORT_DICTIONARY_RESULT  = "ExportDictionaryResult";
 const gchar * const CONFIG_CLEAR_USER_DATA           = "ClearUserData";
 /* const gchar * const CONFIG_CTRL_SWITCH               = "CtrlSwitch"; */
 const gchar * const CONFIG_MAIN_SWITCH               = "MainSwitch";
@@ -108,6 +110,7 @@ LibPinyinConfig::initDefaultValues (void)
     m_init_full_punct = TRUE;
     m_init_simp_chinese = TRUE;
     m_special_phrases = TRUE;
+    m_lua_call_timeout = 500;
 
     m_dictionaries = "";
 
@@ -137,75 +140,68 @@ static const struct {
     { "DynamicAdjust",          DYNAMIC_ADJUST       },
 };
 
+static const gchar * const libpinyin_keys [] = {
+    CONFIG_ORIENTATION,
+    CONFIG_PAGE_SIZE,
+    CONFIG_REMEMBER_EVERY_INPUT,
+    CONFIG_DICTIONARIES,
+    CONFIG_MAIN_SWITCH,
+    CONFIG_LETTER_SWITCH,
+    CONFIG_PUNCT_SWITCH,
+    CONFIG_TRAD_SWITCH,
+    CONFIG_FUZZY_PINYIN,
+};
+
+/* the keys used as signals, never apply them from the snapshot. */
+static inline gboolean
+isActionKey (const std::string &name)
+{
+    return CONFIG_IMPORT_DICTIONARY == name ||
+        CONFIG_EXPORT_DICTIONARY == name ||
+        CONFIG_EXPORT_DICTIONARY_RESULT == name ||
+        CONFIG_CLEAR_USER_DATA == name;
+}
+
 void
 LibPinyinConfig::readDefaultValues (void)
 {
+    initDefaultValues ();
+    loadValues ();
+
 #if defined(HAVE_IBUS_CONFIG_GET_VALUES)
     /* read all values together */
-    initDefaultValues ();
-    GVariant *values =
-            ibus_config_get_values (get<IBusConfig> (), m_section.c_str ());
-    g_return_if_fail (values != NULL);
-
-    GVariantIter iter;
-    gchar *name;
-    GVariant *value;
-    g_variant_iter_init (&iter, values);
-    while (g_variant_iter_next (&iter, "{sv}", &name, &value)) {
-        /* skip signals here. */
-        if (0 == strcmp(CONFIG_IMPORT_DICTIONARY, name))
-            continue;
-
-        if (0 == strcmp(CONFIG_EXPORT_DICTIONARY, name))
-            continue;
-
-        if (0 == strcmp(CONFIG_CLEAR_USER_DATA, name))
-            continue;
-
-        valueChanged (m_section, name, value);
-        g_free (name);
-        g_variant_unref (value);
-    }
-    g_variant_unref (values);
+    fetchValues ();
 #else
-    /* others */
-    m_orientation = read (CONFIG_ORIENTATION, 0);
-    if (m_orientation != IBUS_ORIENTATION_VERTICAL &&
-        m_orientation != IBUS_ORIENTATION_HORIZONTAL) {
-        m_orientation = IBUS_ORIENTATION_HORIZONTAL;
-        g_warn_if_reached ();
-    }
-    m_page_size = read (CONFIG_PAGE_SIZE, 5);
-    if (m_page_size > 10) {
-        m_page_size = 5;
-        g_warn_if_reached ();
-    }
-    m_remember_every_input = read (CONFIG_REMEMBER_EVERY_INPUT, false);
+    for (guint i = 0; i < G_N_ELEMENTS (libpinyin_keys); i++)
+        fetchValue (libpinyin_keys[i]);
+    for (guint i = 0; i < G_N_ELEMENTS (options); i++)
+        fetchValue (options[i].name);
+#endif
+}
 
-    m_dictionaries = read (CONFIG_DICTIONARIES, std::string (""));
+void
+LibPinyinConfig::updateValue (const std::string &name, GVariant *value)
+{
+    if (isActionKey (name))
+        return;
 
-    m_main_switch = read (CONFIG_MAIN_SWITCH, std::string ("<Shift>"));
-    m_letter_switch = read (CONFIG_LETTER_SWITCH, std::string (""));
-    m_punct_switch = read (CONFIG_PUNCT_SWITCH, std::string ("<Control>period"));
-    m_trad_switch = read (CONFIG_TRAD_SWITCH, std::string ("<Control><Shift>f"));
+    Config::updateValue (name, value);
 
-    /* fuzzy pinyin */
-    if (read (CONFIG_FUZZY_PINYIN, false))
-        m_option_mask |= PINYIN_AMB_ALL;
-    else
-        m_option_mask &= ~PINYIN_AMB_ALL;
+    if (m_section == "engine/pinyin")
+        LibPinyinBackEnd::instance ().setPinyinOptions (this);
+    if (m_section == "engine/bopomofo")
+        LibPinyinBackEnd::instance ().setChewingOptions (this);
+}
 
-    /* read values */
-    for (guint i = 0; i < G_N_ELEMENTS (options); i++) {
-        if (read (options[i].name,
-                  (options[i].option & PINYIN_DEFAULT_OPTION) != 0)) {
-            m_option |= options[i].option;
-        }
-        else {
-            m_option &= ~options[i].option;
-        }
-    }
-#endif
+void
+LibPinyinConfig::resetValues (const std::vector<std::string> &names)
+{
+    Config::resetValues (names);
+
+    if (m_section == "engine/pinyin")
+        LibPinyinBackEnd::instance ().setPinyinOptions (this);
+    if (m_section == "engine/bopomofo")
+        LibPinyinBackEnd::instance ().setChewingOptions (this);
 }
 
 gboolean
@@ -277,12 +273,19 @@ LibPinyinConfig::valueChangedCallback (IBusConfig  *config,
     if (self->m_section != section)
         return;
 
-    self->valueChanged (section, name, value);
+    /* signals are always handled, even with the same value. */
+    if (isActionKey (name)) {
+        self->valueChanged (section, name, value);
+        return;
+    }
+
+    /* ibus config sends an empty tuple when the key is unset. */
+    if (value == NULL || g_variant_is_of_type (value, G_VARIANT_TYPE_UNIT)) {
+        self->resetValues (std::vector<std::string> (1, name));
+        return;
+    }
 
-    if (self->m_section == "engine/pinyin")
-        LibPinyinBackEnd::instance ().setPinyinOptions (self);
-    if (self->m_section == "engine/bopomofo")
-        LibPinyinBackEnd::instance ().setChewingOptions (self);
+    self->updateValue (name, value);
 }
 
 static const struct {
@@ -315,6 +318,23 @@ static const struct{
     {5, DOUBLE_PINYIN_XHE}
 };
 
+static const gchar * const pinyin_keys [] = {
+    CONFIG_DOUBLE_PINYIN,
+    CONFIG_DOUBLE_PINYIN_SCHEMA,
+    CONFIG_DOUBLE_PINYIN_SHOW_RAW,
+    CONFIG_INIT_CHINESE,
+    CONFIG_INIT_FULL,
+    CONFIG_INIT_FULL_PUNCT,
+    CONFIG_INIT_SIMP_CHINESE,
+    CONFIG_SPECIAL_PHRASES,
+    CONFIG_LUA_CALL_TIMEOUT,
+    CONFIG_SHIFT_SELECT_CANDIDATE,
+    CONFIG_MINUS_EQUAL_PAGE,
+    CONFIG_COMMA_PERIOD_PAGE,
+    CONFIG_AUTO_COMMIT,
+    CONFIG_CORRECT_PINYIN,
+};
+
 PinyinConfig::PinyinConfig (Bus & bus)
     : LibPinyinConfig (bus, "pinyin")
 {
@@ -334,49 +354,10 @@ PinyinConfig::readDefaultValues (void)
 {
     LibPinyinConfig::readDefaultValues ();
 #if !defined(HAVE_IBUS_CONFIG_GET_VALUES)
-    /* double pinyin */
-    m_double_pinyin = read (CONFIG_DOUBLE_PINYIN, false);
-
-    const gint map = read (CONFIG_DOUBLE_PINYIN_SCHEMA, 0);
-    m_double_pinyin_schema = DOUBLE_PINYIN_DEFAULT;
-
-    for (guint i = 0; i < G_N_ELEMENTS (double_pinyin_schemes); i++) {
-        if (map == double_pinyin_schemes[i].double_pinyin_keyboard) {
-            /* set double pinyin scheme. */
-            m_double_pinyin_schema = double_pinyin_schemes[i].scheme;
-        }
-    }
-
-    m_double_pinyin_show_raw = read (CONFIG_DOUBLE_PINYIN_SHOW_RAW, false);
-
-    /* init states */
-    m_init_chinese = read (CONFIG_INIT_CHINESE, true);
-    m_init_full = read (CONFIG_INIT_FULL, false);
-    m_init_full_punct = read (CONFIG_INIT_FULL_PUNCT, true);
-    m_init_simp_chinese = read (CONFIG_INIT_SIMP_CHINESE, true);
-
-    m_special_phrases = read (CONFIG_SPECIAL_PHRASES, true);
-
-    /* other */
-    m_shift_select_candidate = read (CONFIG_SHIFT_SELECT_CANDIDATE, false);
-    m_minus_equal_page = read (CONFIG_MINUS_EQUAL_PAGE, true);
-    m_comma_period_page = read (CONFIG_COMMA_PERIOD_PAGE, true);
-    m_auto_commit = read (CONFIG_AUTO_COMMIT, false);
-
-    /* correct pinyin */
-    if (read (CONFIG_CORRECT_PINYIN, true))
-        m_option_mask |= PINYIN_CORRECT_ALL;
-    else
-        m_option_mask &= ~PINYIN_CORRECT_ALL;
-
-    /* read values */
-    for (guint i = 0; i < G_N_ELEMENTS (pinyin_options); i++) {
-        if (read (pinyin_options[i].name,
-                (pinyin_options[i].option & PINYIN_DEFAULT_OPTION) != 0))
-            m_option |= pinyin_options[i].option;
-        else
-            m_option &= ~pinyin_options[i].option;
-    }
+    for (guint i = 0; i < G_N_ELEMENTS (pinyin_keys); i++)
+        fetchValue (pinyin_keys[i]);
+    for (guint i = 0; i < G_N_ELEMENTS (pinyin_options); i++)
+        fetchValue (pinyin_options[i].name);
 #endif
 }
 
@@ -418,6 +399,8 @@ PinyinConfig::valueChanged (const std::string &section,
         m_init_simp_chinese = normalizeGVariant (value, true);
     else if (CONFIG_SPECIAL_PHRASES == name)
         m_special_phrases = normalizeGVariant (value, true);
+    else if (CONFIG_LUA_CALL_TIMEOUT == name)
+        m_lua_call_timeout = normalizeGVariant (value, 500);
     /* others */
     else if (CONFIG_SHIFT_SELECT_CANDIDATE == name)
         m_shift_select_candidate = normalizeGVariant (value, false);
@@ -472,6 +455,20 @@ static const struct {
     {3, CHEWING_IBM}
 };
 
+static const gchar * const bopomofo_keys [] = {
+    CONFIG_INIT_CHINESE,
+    CONFIG_INIT_FULL,
+    CONFIG_INIT_FULL_PUNCT,
+    CONFIG_INIT_SIMP_CHINESE,
+    CONFIG_SPECIAL_PHRASES,
+    CONFIG_BOPOMOFO_KEYBOARD_MAPPING,
+    CONFIG_SELECT_KEYS,
+    CONFIG_GUIDE_KEY,
+    CONFIG_AUXILIARY_SELECT_KEY_F,
+    CONFIG_AUXILIARY_SELECT_KEY_KP,
+    CONFIG_ENTER_KEY,
+};
+
 BopomofoConfig::BopomofoConfig (Bus & bus)
     : LibPinyinConfig (bus, "bopomofo")
 {
@@ -487,34 +484,28 @@ BopomofoConfig::init (Bus & bus)
 }
 
 void
-BopomofoConfig::readDefaultValues (void)
+BopomofoConfig::initDefaultValues (void)
 {
-    LibPinyinConfig::readDefaultValues ();
-#if !defined(HAVE_IBUS_CONFIG_GET_VALUES)
-    /* init states */
-    m_init_chinese = read (CONFIG_INIT_CHINESE, true);
-    m_init_full = read (CONFIG_INIT_FULL, false);
-    m_init_full_punct = read (CONFIG_INIT_FULL_PUNCT, true);
-    m_init_simp_chinese = read (CONFIG_INIT_SIMP_CHINESE, false);
+    LibPinyinConfig::initDefaultValues ();
 
-    m_special_phrases = read (CONFIG_SPECIAL_PHRASES, false);
+    m_init_simp_chinese = FALSE;
+    m_special_phrases = FALSE;
 
-    const gint map = read (CONFIG_BOPOMOFO_KEYBOARD_MAPPING, 0);
     m_bopomofo_keyboard_mapping = CHEWING_DEFAULT;
+    m_select_keys = 0;
+    m_guide_key = TRUE;
+    m_auxiliary_select_key_f = TRUE;
+    m_auxiliary_select_key_kp = TRUE;
+    m_enter_key = TRUE;
+}
 
-    for (guint i = 0; i < G_N_ELEMENTS (chewing_schemes); i++) {
-        if (map == chewing_schemes[i].bopomofo_keyboard) {
-            /* set chewing scheme. */
-            m_bopomofo_keyboard_mapping = chewing_schemes[i].scheme;
-        }
-    }
-
-    m_select_keys = read (CONFIG_SELECT_KEYS, 0);
-    if (m_select_keys >= 9) m_select_keys = 0;
-    m_guide_key = read (CONFIG_GUIDE_KEY, true);
-    m_auxiliary_select_key_f = read (CONFIG_AUXILIARY_SELECT_KEY_F, true);
-    m_auxiliary_select_key_kp = read (CONFIG_AUXILIARY_SELECT_KEY_KP, true);
-    m_enter_key = read (CONFIG_ENTER_KEY, true);
+void
+BopomofoConfig::readDefaultValues (void)
+{
+    LibPinyinConfig::readDefaultValues ();
+#if !defined(HAVE_IBUS_CONFIG_GET_VALUES)
+    for (guint i = 0; i < G_N_ELEMENTS (bopomofo_keys); i++)
+        fetchValue (bopomofo_keys[i]);
 #endif
 }
 
@@ -36,6 +36,9 @@ namespace PY {
 
 class Bus;
 
+extern const gchar * const CONFIG_DOUBLE_PINYIN;
+extern const gchar * const CONFIG_EXPORT_DICTIONARY_RESULT;
+
 class LibPinyinConfig : public Config {
 protected:
     LibPinyinConfig (Bus & bus, const std::string & name);
@@ -44,9 +47,11 @@ protected:
 public:
 
 protected:
-    void initDefaultValues (void);
+    virtual void initDefaultValues (void);
 
     virtual void readDefaultValues (void);
+    virtual void updateValue (const std::string &name, GVariant *value);
+    virtual void resetValues (const std::vector<std::string> &names);
     virtual gboolean valueChanged (const std::string &section,
                                    const std::string &name,
                                    GVariant          *value);
@@ -86,6 +91,7 @@ public:
 
 protected:
     BopomofoConfig (Bus & bus);
+    virtual void initDefaultValues (void);
     virtual void readDefaultValues (void);
 
     virtual gboolean valueChanged (const std::string &section,
@@ -103,6 +103,8 @@ DoublePinyinEditor::processKeyEvent (guint keyval, guint keycode,
 void
 DoublePinyinEditor::updatePinyin (void)
 {
+    invalidateCandidates ();
+
     if (G_UNLIKELY (m_text.empty ())) {
         m_pinyin_len = 0;
         /* TODO: check whether to replace "" with NULL. */
@@ -140,25 +142,21 @@ DoublePinyinEditor::updateAuxiliaryText (void)
         guint16 cursor = 0, end = 0;
         pinyin_get_pinyin_key_rest_positions (m_instance, pos, &cursor, &end);
 
-        gchar * str = NULL;
         if (G_UNLIKELY (cursor == m_cursor)) { /* at word boundary. */
-            pinyin_get_pinyin_string (m_instance, key, &str);
-            m_buffer << '|' << str;
-            g_free (str);
+            m_buffer << '|' << getKeyString (key, pos);
         } else if (G_LIKELY (cursor < m_cursor &&
                              m_cursor < end)) { /* in word */
             guint16 length = 0;
             pinyin_get_pinyin_key_rest_length (m_instance, pos, &length);
 
             /* raw text */
-            String raw = m_text.substr (cursor, length);
             guint offset = m_cursor - cursor;
-            m_buffer << ' ' << raw.substr (0, offset)
-                     << '|' << raw.substr (offset);
+            m_buffer << ' ';
+            m_buffer.append (m_text, cursor, offset);
+            m_buffer << '|';
+            m_buffer.append (m_text, m_cursor, length - offset);
         } else { /* other words */
-            pinyin_get_pinyin_string (m_instance, key, &str);
-            m_buffer << ' ' << str;
-            g_free (str);
+            m_buffer << ' ' << getKeyString (key, pos);
         }
     }
 
@@ -169,6 +167,6 @@ DoublePinyinEditor::updateAuxiliaryText (void)
     const gchar * p = m_text.c_str() + m_pinyin_len;
     m_buffer << p;
 
-    StaticText aux_text (m_buffer);
+    Text aux_text (m_auxiliary_text.reset (m_buffer));
     Editor::updateAuxiliaryText (aux_text, TRUE);
 }
@@ -38,9 +38,9 @@ public:
     virtual gboolean processKeyEvent (guint keyval, guint keycode, guint modifiers);
     virtual void reset (void);
     virtual void updateAuxiliaryText (void);
-    virtual void update (void);
 
 protected:
+    virtual void guessCandidates (guint lookup_cursor);
 
     virtual void updatePinyin (void);
 
@@ -19,9 +19,16 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 #include "PYPPhoneticEditor.h"
+#include <string.h>
 #include "PYConfig.h"
 #include "PYPinyinProperties.h"
 #include "PYSimpTradConverter.h"
+#include "PYSpecialPhraseTable.h"
+#ifdef IBUS_BUILD_LUA_EXTENSION
+extern "C" {
+#include "lua-plugin.h"
+}
+#endif
 
 using namespace PY;
 
@@ -30,8 +37,15 @@ PhoneticEditor::PhoneticEditor (PinyinProperties &props,
                                                   Config &config):
     Editor (props, config),
     m_pinyin_len (0),
-    m_lookup_table (m_config.pageSize ())
-{
+    m_lookup_table (m_config.pageSize ()),
+    m_guessed_cursor (G_MAXUINT),
+    m_key_strings_option (m_config.option ()),
+    m_key_strings_pinyin_scheme (m_config.doublePinyinSchema ()),
+    m_key_strings_chewing_scheme (m_config.bopomofoKeyboardMapping ())
+{
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    m_lua_trigger_begin = 0;
+#endif
 }
 
 PhoneticEditor::~PhoneticEditor (){
@@ -171,6 +185,9 @@ PhoneticEditor::processKeyEvent (guint keyval, guint keycode, guint modifiers)
 void
 PhoneticEditor::updateLookupTableFast (void)
 {
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    convertLookupTablePage ();
+#endif
     Editor::updateLookupTableFast (m_lookup_table, TRUE);
 }
 
@@ -180,8 +197,12 @@ PhoneticEditor::updateLookupTable (void)
     m_lookup_table.clear ();
 
     fillLookupTable ();
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    m_converted_candidates.clear ();
+    convertLookupTablePage ();
+#endif
     if (m_lookup_table.size()) {
-        Editor::updateLookupTable (m_lookup_table, TRUE);
+        Editor::updateLookupTableFast (m_lookup_table, TRUE);
     } else {
         hideLookupTable ();
     }
@@ -230,29 +251,235 @@ PhoneticEditor::fillLookupTableByPage (void)
 }
 #endif
 
+#ifdef IBUS_BUILD_LUA_EXTENSION
+void
+PhoneticEditor::callLuaTrigger (const lua_trigger_t *trigger,
+                                const gchar *argument)
+{
+    ibus_engine_plugin_set_call_timeout (m_lua_plugin, m_config.luaCallTimeout ());
+    int num = ibus_engine_plugin_call
+        (m_lua_plugin, trigger->lua_function_name, argument);
+
+    if (1 == num) {
+        lua_command_candidate_t * candidate = (lua_command_candidate_t *)
+            ibus_engine_plugin_get_retval (m_lua_plugin);
+        if (candidate->content)
+            m_lua_trigger_candidates.push_back (candidate->content);
+        ibus_engine_plugin_free_candidate (candidate);
+    } else if (num > 1) {
+        GArray * candidates = ibus_engine_plugin_get_retvals (m_lua_plugin);
+        for (guint i = 0; i < candidates->len; i++) {
+            lua_command_candidate_t * candidate =
+                g_array_index (candidates, lua_command_candidate_t *, i);
+            if (candidate->content)
+                m_lua_trigger_candidates.push_back (candidate->content);
+            ibus_engine_plugin_free_candidate (candidate);
+        }
+        g_array_free (candidates, TRUE);
+    }
+}
+
 gboolean
-PhoneticEditor::fillLookupTable (void)
+PhoneticEditor::fillLuaTriggerCandidates (guint lookup_cursor, guint len)
 {
-    guint len = 0;
-    pinyin_get_n_candidate (m_instance, &len);
+    m_lua_trigger_candidates.clear ();
 
-    String word;
+    if (!m_lua_plugin)
+        return FALSE;
+
+    /* only call into lua when some trigger string is matched. */
+    GArray * triggers = ibus_engine_plugin_match_input_triggers
+        (m_lua_plugin, m_text.c_str ());
+    if (triggers) {
+        for (guint i = 0; i < triggers->len; i++) {
+            const lua_trigger_t * trigger =
+                g_array_index (triggers, const lua_trigger_t *, i);
+            callLuaTrigger (trigger, m_text.c_str ());
+        }
+        g_array_free (triggers, TRUE);
+    }
+
+    /* check the candidates in the first page. */
+    len = MIN (len, m_lookup_table.pageSize ());
     for (guint i = 0; i < len; i++) {
-        lookup_candidate_t * candidate = NULL;
-        pinyin_get_candidate (m_instance, i, &candidate);
+        const gchar * phrase_string = getCandidateString (lookup_cursor, i);
 
-        const gchar * phrase_string = NULL;
-        pinyin_get_candidate_string (m_instance, candidate, &phrase_string);
+        const lua_trigger_t * trigger =
+            ibus_engine_plugin_match_candidate_trigger
+            (m_lua_plugin, phrase_string);
+        if (trigger)
+            callLuaTrigger (trigger, phrase_string);
+    }
 
-        /* show get candidates. */
-        if (G_LIKELY (m_props.modeSimp ())) {
-            word = phrase_string;
-        } else { /* Traditional Chinese */
-            word.truncate (0);
-            SimpTradConverter::simpToTrad (phrase_string, word);
-        }
+    return !m_lua_trigger_candidates.empty ();
+}
 
-        Text text (word);
+void
+PhoneticEditor::appendLuaTriggerCandidates (void)
+{
+    std::vector<std::string>::iterator iter;
+    for (iter = m_lua_trigger_candidates.begin ();
+         iter != m_lua_trigger_candidates.end (); ++iter) {
+        Text text (*iter);
+        m_lookup_table.appendCandidate (text);
+    }
+}
+
+void
+PhoneticEditor::convertLookupTablePage (void)
+{
+    if (!m_lua_plugin)
+        return;
+    if (0 == ibus_engine_plugin_get_available_converters (m_lua_plugin)->len)
+        return;
+
+    guint size = m_lookup_table.size ();
+    guint page_size = m_lookup_table.pageSize ();
+    guint begin = m_lookup_table.cursorPos () / page_size * page_size;
+    guint end = MIN (begin + page_size, size);
+    m_converted_candidates.resize (size, false);
+
+    /* convert the current page in one batch. */
+    std::vector<guint> indexes;
+    std::vector<gchar *> texts;
+    for (guint i = begin; i < end; i++) {
+        if (m_converted_candidates[i])
+            continue;
+        m_converted_candidates[i] = true;
+        indexes.push_back (i);
+        texts.push_back (g_strdup (m_lookup_table.getCandidate (i)->text));
+    }
+
+    if (indexes.empty ())
+        return;
+
+    texts.push_back (NULL);
+    ibus_engine_plugin_convert (m_lua_plugin, &texts[0]);
+
+    for (guint i = 0; i < indexes.size (); i++) {
+        Text text (texts[i]);
+        m_lookup_table.setCandidate (indexes[i], text);
+        g_free (texts[i]);
+    }
+}
+
+void
+PhoneticEditor::convertText (String &text)
+{
+    if (!m_lua_plugin)
+        return;
+    if (0 == ibus_engine_plugin_get_available_converters (m_lua_plugin)->len)
+        return;
+
+    gchar *texts[] = { g_strdup (text), NULL };
+    ibus_engine_plugin_convert (m_lua_plugin, texts);
+    text = texts[0];
+    g_free (texts[0]);
+}
+#endif
+
+gboolean
+PhoneticEditor::formatKeyString (PinyinKey *key, gchar **str)
+{
+    return pinyin_get_pinyin_string (m_instance, key, str);
+}
+
+const std::string &
+PhoneticEditor::getKeyString (PinyinKey *key, PinyinKeyPos *pos)
+{
+    guint16 begin = 0, length = 0;
+    pinyin_get_pinyin_key_rest_positions (m_instance, pos, &begin, NULL);
+    pinyin_get_pinyin_key_rest_length (m_instance, pos, &length);
+
+    /* the same raw text always parses to the same key, until the parser
+       options or the scheme change. */
+    if (G_UNLIKELY (m_key_strings_option != m_config.option () ||
+                    m_key_strings_pinyin_scheme != m_config.doublePinyinSchema () ||
+                    m_key_strings_chewing_scheme != m_config.bopomofoKeyboardMapping ())) {
+        m_key_strings.clear ();
+        m_key_strings_option = m_config.option ();
+        m_key_strings_pinyin_scheme = m_config.doublePinyinSchema ();
+        m_key_strings_chewing_scheme = m_config.bopomofoKeyboardMapping ();
+    }
+
+    guint64 raw = 0;
+    std::map<guint64, std::string>::iterator iter = m_key_strings.end ();
+    if (G_LIKELY (length <= sizeof (raw))) {
+        memcpy (&raw, m_text.c_str () + begin, length);
+        iter = m_key_strings.find (raw);
+        if (G_LIKELY (iter != m_key_strings.end ()))
+            return iter->second;
+    }
+
+    gchar *str = NULL;
+    formatKeyString (key, &str);
+    std::string &result = (length <= sizeof (raw)) ?
+        m_key_strings[raw] : m_key_string;
+    result = str ? str : "";
+    g_free (str);
+    return result;
+}
+
+gboolean
+PhoneticEditor::fillSpecialPhrases (void)
+{
+    m_special_phrases.clear ();
+
+    if (!m_config.specialPhrases ())
+        return FALSE;
+
+    /* only look up the whole input, before any candidate is selected. */
+    if (m_cursor != m_text.length () || getLookupCursor () != 0)
+        return FALSE;
+
+    return SpecialPhraseTable::instance ().lookup (m_text, m_special_phrases);
+}
+
+gboolean
+PhoneticEditor::fillLookupTable (void)
+{
+    guint lookup_cursor = getLookupCursor ();
+    guint len = getCandidates (lookup_cursor);
+
+    /* show special phrases before the other candidates. */
+    fillSpecialPhrases ();
+    std::vector<std::string>::iterator iter;
+    for (iter = m_special_phrases.begin ();
+         iter != m_special_phrases.end (); ++iter) {
+        Text text (*iter);
+        m_lookup_table.appendCandidate (text);
+    }
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    /* show lua trigger candidates after the best match candidate. */
+    fillLuaTriggerCandidates (lookup_cursor, len);
+    m_lua_trigger_begin = MIN (1, len);
+    if (0 == len)
+        appendLuaTriggerCandidates ();
+#endif
+
+    String word;
+    TextCache &cache = m_props.modeSimp () ?
+        m_simp_candidate_texts : m_trad_candidate_texts;
+    for (guint i = 0; i < len; i++) {
+#ifdef IBUS_BUILD_LUA_EXTENSION
+        if (G_UNLIKELY (i == m_lua_trigger_begin))
+            appendLuaTriggerCandidates ();
+#endif
+        const gchar * phrase_string = getCandidateString (lookup_cursor, i);
+
+        /* the cached text is already converted for the mode. */
+        IBusText *text = cache.lookup (phrase_string);
+        if (G_UNLIKELY (text == NULL)) {
+            if (G_LIKELY (m_props.modeSimp ())) {
+                text = ibus_text_new_from_string (phrase_string);
+            } else { /* Traditional Chinese */
+                word.truncate (0);
+                SimpTradConverter::simpToTrad (phrase_string, word);
+                text = ibus_text_new_from_string (word);
+            }
+            cache.insert (phrase_string, text);
+        }
         m_lookup_table.appendCandidate (text);
     }
 
@@ -310,8 +537,13 @@ PhoneticEditor::reset (void)
 {
     m_pinyin_len = 0;
     m_lookup_table.clear ();
+    m_special_phrases.clear ();
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    m_lua_trigger_candidates.clear ();
+#endif
 
     pinyin_reset (m_instance);
+    invalidateCandidates ();
 
     Editor::reset ();
 }
@@ -319,9 +551,7 @@ PhoneticEditor::reset (void)
 void
 PhoneticEditor::update (void)
 {
-    guint lookup_cursor = getLookupCursor ();
-    pinyin_guess_candidates (m_instance, lookup_cursor);
-
+    /* the candidates are guessed by fillLookupTable when not cached. */
     updateLookupTable ();
     updatePreeditText ();
     updateAuxiliaryText ();
@@ -346,6 +576,71 @@ PhoneticEditor::getPinyinCursor ()
     return pinyin_cursor;
 }
 
+guint
+PhoneticEditor::getCandidates (guint lookup_cursor)
+{
+    if (m_guessed_cursor != lookup_cursor) {
+        std::map<guint, std::vector<std::string> >::iterator iter =
+            m_candidates.find (lookup_cursor);
+        if (iter != m_candidates.end ())
+            return iter->second.size ();
+        prepareCandidates (lookup_cursor);
+    }
+
+    guint len = 0;
+    pinyin_get_n_candidate (m_instance, &len);
+    return len;
+}
+
+const gchar *
+PhoneticEditor::getCandidateString (guint lookup_cursor, guint i)
+{
+    if (m_guessed_cursor != lookup_cursor)
+        return m_candidates[lookup_cursor][i].c_str ();
+
+    lookup_candidate_t * candidate = NULL;
+    pinyin_get_candidate (m_instance, i, &candidate);
+
+    const gchar * phrase_string = NULL;
+    pinyin_get_candidate_string (m_instance, candidate, &phrase_string);
+    return phrase_string;
+}
+
+void
+PhoneticEditor::prepareCandidates (guint lookup_cursor)
+{
+    /* m_instance only holds the candidates of one lookup cursor. */
+    if (m_guessed_cursor == lookup_cursor)
+        return;
+
+    /* keep the guessed candidates, the lookup cursor moves away. */
+    if (m_guessed_cursor != G_MAXUINT &&
+        m_candidates.find (m_guessed_cursor) == m_candidates.end ()) {
+        std::vector<std::string> & candidates = m_candidates[m_guessed_cursor];
+        guint len = 0;
+        pinyin_get_n_candidate (m_instance, &len);
+        candidates.reserve (len);
+        for (guint i = 0; i < len; i++)
+            candidates.push_back (getCandidateString (m_guessed_cursor, i));
+    }
+
+    guessCandidates (lookup_cursor);
+    m_guessed_cursor = lookup_cursor;
+}
+
+void
+PhoneticEditor::invalidateCandidates (void)
+{
+    m_candidates.clear ();
+    m_guessed_cursor = G_MAXUINT;
+}
+
+void
+PhoneticEditor::guessCandidates (guint lookup_cursor)
+{
+    pinyin_guess_candidates (m_instance, lookup_cursor);
+}
+
 guint
 PhoneticEditor::getLookupCursor (void)
 {
@@ -362,14 +657,38 @@ PhoneticEditor::getLookupCursor (void)
 gboolean
 PhoneticEditor::selectCandidate (guint i)
 {
+    guint special_len = m_special_phrases.size ();
+    if (G_UNLIKELY (i < special_len)) {
+        std::string str = m_special_phrases[i];
+        commit (str.c_str ());
+        reset ();
+        return TRUE;
+    }
+    i -= special_len;
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    guint lua_len = m_lua_trigger_candidates.size ();
+    if (G_UNLIKELY (lua_len && i >= m_lua_trigger_begin)) {
+        if (i < m_lua_trigger_begin + lua_len) {
+            std::string str = m_lua_trigger_candidates[i - m_lua_trigger_begin];
+            commit (str.c_str ());
+            reset ();
+            return TRUE;
+        }
+        i -= lua_len;
+    }
+#endif
+
+    guint lookup_cursor = getLookupCursor ();
+    /* the shown candidates may come from the cache. */
+    prepareCandidates (lookup_cursor);
+
     guint len = 0;
     pinyin_get_n_candidate (m_instance, &len);
 
     if (G_UNLIKELY (i >= len))
         return FALSE;
 
-    guint lookup_cursor = getLookupCursor ();
-
     lookup_candidate_t * candidate = NULL;
     pinyin_get_candidate (m_instance, i, &candidate);
 
@@ -383,6 +702,7 @@ PhoneticEditor::selectCandidate (guint i)
 
     lookup_cursor = pinyin_choose_candidate
         (m_instance, lookup_cursor, candidate);
+    invalidateCandidates ();
 
     if (DIVIDED_CANDIDATE == type ||
         RESPLIT_CANDIDATE == type) {
@@ -397,7 +717,8 @@ PhoneticEditor::selectCandidate (guint i)
     len = 0;
     pinyin_get_n_pinyin (m_instance, &len);
     if (lookup_cursor == len) {
-        pinyin_train(m_instance);
+        if (m_learning)
+            pinyin_train(m_instance);
         commit();
         return TRUE;
     }
@@ -22,8 +22,18 @@
 #define __PY_LIB_PINYIN_BASE_EDITOR_H_
 
 #include <pinyin.h>
+#include <map>
+#include <string>
+#include <vector>
 #include "PYLookupTable.h"
 #include "PYEditor.h"
+#include "PYText.h"
+#ifdef IBUS_BUILD_LUA_EXTENSION
+#include "PYPointer.h"
+
+typedef struct _IBusEnginePlugin IBusEnginePlugin;
+typedef struct _lua_trigger_t lua_trigger_t;
+#endif
 
 
 namespace PY {
@@ -49,6 +59,10 @@ public:
     virtual void updateLookupTableFast ();
     virtual gboolean fillLookupTable ();
 
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    void setLuaPlugin (IBusEnginePlugin *plugin) { m_lua_plugin = plugin; }
+#endif
+
 protected:
     gboolean selectCandidate (guint i);
     gboolean selectCandidateInPage (guint i);
@@ -57,6 +71,15 @@ protected:
     guint getPinyinCursor (void);
     guint getLookupCursor (void);
 
+    /* candidates of the lookup cursor, guessed once until the pinyin is
+     * parsed again or a candidate is chosen. getCandidates returns the
+     * number of candidates. */
+    guint getCandidates (guint lookup_cursor);
+    const gchar * getCandidateString (guint lookup_cursor, guint i);
+    void prepareCandidates (guint lookup_cursor);
+    void invalidateCandidates (void);
+    virtual void guessCandidates (guint lookup_cursor);
+
     /* inline functions */
 
     /* pure virtual functions */
@@ -79,6 +102,21 @@ protected:
     guint getCursorLeftByWord (void);
     guint getCursorRightByWord (void);
 
+    gboolean fillSpecialPhrases (void);
+
+    /* pinyin string of the key, cached by its raw text. */
+    const std::string & getKeyString (PinyinKey *key, PinyinKeyPos *pos);
+    virtual gboolean formatKeyString (PinyinKey *key, gchar **str);
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    gboolean fillLuaTriggerCandidates (guint lookup_cursor, guint len);
+    void callLuaTrigger (const lua_trigger_t *trigger, const gchar *argument);
+    void appendLuaTriggerCandidates (void);
+
+    void convertLookupTablePage (void);
+    void convertText (String &text);
+#endif
+
 
     /* varibles */
     guint                       m_pinyin_len;
@@ -87,6 +125,38 @@ protected:
 
     /* use LibPinyinBackEnd here. */
     pinyin_instance_t           *m_instance;
+
+    std::vector<std::string>    m_special_phrases;
+
+    /* candidate strings by lookup cursor, for the parsed pinyin. Only
+     * copied from m_instance when another lookup cursor is guessed. */
+    std::map<guint, std::vector<std::string> > m_candidates;
+    /* lookup cursor of the candidates guessed in m_instance, they are
+     * read from m_instance directly. */
+    guint                       m_guessed_cursor;
+
+    /* reused while preedit and auxiliary text do not change. */
+    PooledText                  m_preedit_text;
+    PooledText                  m_auxiliary_text;
+
+    /* candidate texts of simplified and traditional Chinese. */
+    TextCache                   m_simp_candidate_texts;
+    TextCache                   m_trad_candidate_texts;
+
+    /* pinyin strings of the keys by raw text, kept over the inputs, for
+     * the parser options and the schemes below. */
+    std::map<guint64, std::string> m_key_strings;
+    std::string                 m_key_string;
+    pinyin_option_t             m_key_strings_option;
+    DoublePinyinScheme          m_key_strings_pinyin_scheme;
+    ChewingScheme               m_key_strings_chewing_scheme;
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    Pointer<IBusEnginePlugin>   m_lua_plugin;
+    std::vector<std::string>    m_lua_trigger_candidates;
+    guint                       m_lua_trigger_begin;
+    std::vector<bool>           m_converted_candidates;
+#endif
 };
 
 };
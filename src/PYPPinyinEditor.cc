@@ -221,17 +221,20 @@ PinyinEditor::commit ()
     /* text after pinyin */
     const gchar *p = m_text.c_str() + m_pinyin_len;
     if (G_UNLIKELY (m_props.modeFull ())) {
-        while (*p != '\0') {
-            m_buffer.appendUnichar (HalfFullConverter::toFull (*p++));
-        }
+        HalfFullConverter::toFull (p, m_buffer);
     } else {
         m_buffer << p;
     }
 
-    pinyin_train (m_instance);
-    if (m_config.rememberEveryInput ())
-        LibPinyinBackEnd::instance ().rememberUserInput (m_instance);
-    LibPinyinBackEnd::instance ().modified ();
+    if (m_learning) {
+        pinyin_train (m_instance);
+        if (m_config.rememberEveryInput ())
+            LibPinyinBackEnd::instance ().rememberUserInput (m_instance);
+        LibPinyinBackEnd::instance ().modified ();
+    }
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    convertText (m_buffer);
+#endif
     PhoneticEditor::commit ((const gchar *)m_buffer);
     reset();
 }
@@ -262,9 +265,8 @@ PinyinEditor::updatePreeditText ()
     const gchar *p = m_text.c_str () + m_pinyin_len;
     m_buffer << p;
 
-    StaticText preedit_text (m_buffer);
     /* underline */
-    preedit_text.appendAttribute (IBUS_ATTR_TYPE_UNDERLINE, IBUS_ATTR_UNDERLINE_SINGLE, 0, -1);
+    Text preedit_text (m_preedit_text.reset (m_buffer, TRUE));
 
     guint pinyin_cursor = getPinyinCursor ();
     Editor::updatePreeditText (preedit_text, pinyin_cursor, TRUE);
@@ -292,18 +294,17 @@ PinyinEditor::updateAuxiliaryText ()
         PinyinKey *key = NULL;
         pinyin_get_pinyin_key (m_instance, i, &key);
 
-        gchar * str = NULL;
-        pinyin_get_pinyin_string (m_instance, key, &str);
+        PinyinKeyPos *pos = NULL;
+        pinyin_get_pinyin_key_rest (m_instance, i, &pos);
 
-        m_buffer << str;
-        g_free (str);
+        m_buffer << getKeyString (key, pos);
     }
 
     /* append rest text */
     const gchar *p = m_text.c_str() + m_pinyin_len;
     m_buffer << p;
 
-    StaticText aux_text (m_buffer);
+    Text aux_text (m_auxiliary_text.reset (m_buffer));
     Editor::updateAuxiliaryText (aux_text, TRUE);
 }
 
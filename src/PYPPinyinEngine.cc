@@ -81,18 +81,30 @@ PinyinEngine::PinyinEngine (IBusEngine *engine)
 #endif
 
     m_props.signalUpdateProperty ().connect
-        (std::bind (&PinyinEngine::updateProperty, this, _1));
+        (this, &PinyinEngine::updateProperty);
 
     for (i = MODE_INIT; i < MODE_LAST; i++) {
         connectEditorSignals (m_editors[i]);
     }
 
     connectEditorSignals (m_fallback_editor);
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    /* follow the lua state reloaded by extension editor. */
+    ExtEditor *ext_editor =
+        static_cast<ExtEditor *> (m_editors[MODE_EXTENSION].get ());
+    ext_editor->signalLuaPluginChanged ().connect (
+        this, &PinyinEngine::connectLuaPlugin);
+    connectLuaPlugin ();
+#endif
+
+    PinyinConfig::instance ().addObserver (CONFIG_DOUBLE_PINYIN, this);
 }
 
 /* destructor */
 PinyinEngine::~PinyinEngine (void)
 {
+    PinyinConfig::instance ().removeObserver (this);
 }
 
 /* keep synced with bopomofo engine. */
@@ -166,7 +178,9 @@ PinyinEngine::processKeyEvent (guint keyval, guint keycode, guint modifiers)
 {
     gboolean retval = FALSE;
 
-    if (contentIsPassword ())
+    /* no conversion is wanted in password and latin fields, the keys
+     * go to the application untouched. */
+    if (contentIsPassword () || contentIsLatin ())
         return retval;
 
     if (processAccelKeyEvent (keyval, keycode, modifiers))
@@ -233,32 +247,58 @@ PinyinEngine::processKeyEvent (guint keyval, guint keycode, guint modifiers)
 void
 PinyinEngine::focusIn (void)
 {
-    /* TODO: check memory leak here,
-     *       or switch full/double pinyin when pinyin config is changed.*/
-    if (PinyinConfig::instance ().doublePinyin ()) {
-        if (!m_double_pinyin) {
-            m_editors[MODE_INIT].reset (new DoublePinyinEditor (m_props, PinyinConfig::instance ()));
-            connectEditorSignals (m_editors[MODE_INIT]);
-        }
-        m_double_pinyin = TRUE;
-    }
-    else {
-        if (m_double_pinyin) {
-            m_editors[MODE_INIT].reset (new FullPinyinEditor (m_props, PinyinConfig::instance ()));
-            connectEditorSignals (m_editors[MODE_INIT]);
-        }
-        m_double_pinyin = FALSE;
-    }
-
     registerProperties (m_props.properties ());
 }
 
+/* switch full/double pinyin editor when pinyin config is changed. */
+void
+PinyinEngine::configChanged (Config &config, const std::string &name)
+{
+    if (config.doublePinyin () == m_double_pinyin)
+        return;
+
+    reset ();
+
+    m_double_pinyin = config.doublePinyin ();
+    if (m_double_pinyin)
+        m_editors[MODE_INIT].reset (new DoublePinyinEditor (m_props, PinyinConfig::instance ()));
+    else
+        m_editors[MODE_INIT].reset (new FullPinyinEditor (m_props, PinyinConfig::instance ()));
+    connectEditorSignals (m_editors[MODE_INIT]);
+    m_editors[MODE_INIT]->setLearning (!contentSkipsLearning ());
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    connectLuaPlugin ();
+#endif
+}
+
 void
 PinyinEngine::focusOut (void)
 {
     Engine::focusOut ();
 
     reset ();
+    updateLearning ();
+}
+
+#if IBUS_CHECK_VERSION (1, 5, 4)
+void
+PinyinEngine::setContentType (guint purpose, guint hints)
+{
+    Engine::setContentType (purpose, hints);
+
+    /* latin fields bypass the editors, drop the pending preedit. */
+    if (contentIsLatin ())
+        reset ();
+    updateLearning ();
+}
+#endif
+
+void
+PinyinEngine::updateLearning (void)
+{
+    gboolean learning = !contentSkipsLearning ();
+    for (gint i = 0; i < MODE_LAST; i++)
+        m_editors[i]->setLearning (learning);
 }
 
 void
@@ -352,29 +392,41 @@ PinyinEngine::commitText (Text & text)
 void
 PinyinEngine::connectEditorSignals (EditorPtr editor)
 {
-    editor->signalCommitText ().connect (
-        std::bind (&PinyinEngine::commitText, this, _1));
+    editor->signalCommitText ().connect (this, &PinyinEngine::commitText);
 
     editor->signalUpdatePreeditText ().connect (
-        std::bind (&PinyinEngine::updatePreeditText, this, _1, _2, _3));
+        this, &PinyinEngine::updatePreeditText);
     editor->signalShowPreeditText ().connect (
-        std::bind (&PinyinEngine::showPreeditText, this));
+        this, &PinyinEngine::showPreeditText);
     editor->signalHidePreeditText ().connect (
-        std::bind (&PinyinEngine::hidePreeditText, this));
+        this, &PinyinEngine::hidePreeditText);
 
     editor->signalUpdateAuxiliaryText ().connect (
-        std::bind (&PinyinEngine::updateAuxiliaryText, this, _1, _2));
+        this, &PinyinEngine::updateAuxiliaryText);
     editor->signalShowAuxiliaryText ().connect (
-        std::bind (&PinyinEngine::showAuxiliaryText, this));
+        this, &PinyinEngine::showAuxiliaryText);
     editor->signalHideAuxiliaryText ().connect (
-        std::bind (&PinyinEngine::hideAuxiliaryText, this));
+        this, &PinyinEngine::hideAuxiliaryText);
 
     editor->signalUpdateLookupTable ().connect (
-        std::bind (&PinyinEngine::updateLookupTable, this, _1, _2));
+        this, &PinyinEngine::updateLookupTable);
     editor->signalUpdateLookupTableFast ().connect (
-        std::bind (&PinyinEngine::updateLookupTableFast, this, _1, _2));
+        this, &PinyinEngine::updateLookupTableFast);
     editor->signalShowLookupTable ().connect (
-        std::bind (&PinyinEngine::showLookupTable, this));
+        this, &PinyinEngine::showLookupTable);
     editor->signalHideLookupTable ().connect (
-        std::bind (&PinyinEngine::hideLookupTable, this));
+        this, &PinyinEngine::hideLookupTable);
 }
+
+#ifdef IBUS_BUILD_LUA_EXTENSION
+void
+PinyinEngine::connectLuaPlugin (void)
+{
+    /* share the lua triggers loaded by extension editor. */
+    ExtEditor *ext_editor =
+        static_cast<ExtEditor *> (m_editors[MODE_EXTENSION].get ());
+    PhoneticEditor *phonetic_editor =
+        static_cast<PhoneticEditor *> (m_editors[MODE_INIT].get ());
+    phonetic_editor->setLuaPlugin (ext_editor->luaPlugin ());
+}
+#endif
@@ -24,9 +24,10 @@
 
 #include "PYEngine.h"
 #include "PYPinyinProperties.h"
+#include "PYConfig.h"
 
 namespace PY {
-class PinyinEngine : public Engine {
+class PinyinEngine : public Engine, public ConfigObserver {
 public:
     PinyinEngine (IBusEngine *engine);
     ~PinyinEngine (void);
@@ -37,6 +38,9 @@ public:
     gboolean processKeyEvent (guint keyval, guint keycode, guint modifiers);
     void focusIn (void);
     void focusOut (void);
+#if IBUS_CHECK_VERSION (1, 5, 4)
+    void setContentType (guint purpose, guint hints);
+#endif
     void reset (void);
     void enable (void);
     void disable (void);
@@ -47,11 +51,17 @@ public:
     gboolean propertyActivate (const gchar *prop_name, guint prop_state);
     void candidateClicked (guint index, guint button, guint state);
 
+    void configChanged (Config &config, const std::string &name);
+
 private:
     gboolean processPunct (guint keyval, guint keycode, guint modifiers);
 
     void showSetupDialog (void);
     void connectEditorSignals (EditorPtr editor);
+    void updateLearning (void);
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    void connectLuaPlugin (void);
+#endif
 
     void commitText (Text & text);
 
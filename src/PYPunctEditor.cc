@@ -507,7 +507,7 @@ void
 PunctEditor::updateLookupTable (void)
 {
     if (m_lookup_table.size ()) {
-        Editor::updateLookupTable (m_lookup_table, TRUE);
+        Editor::updateLookupTableFast (m_lookup_table, TRUE);
     }
     else {
         hideLookupTable ();
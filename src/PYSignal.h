@@ -21,89 +21,150 @@
 #ifndef __PY_SIGNAL_H_
 #define __PY_SIGNAL_H_
 
-
-#ifdef HAVE_CONFIG_H
-#  include <config.h>
-#endif
-
-#ifdef __GXX_EXPERIMENTAL_CXX0X__
-
-#  include <functional>
+#include <cstddef>
 
 namespace PY {
 
-using namespace std::placeholders;
+/* A signal is a delegate: the object pointer and the member function
+ * pointer are stored as is, and called through a stub instantiated for
+ * the object type. Nothing is allocated on connect or emit. */
 
-// implement signal templates
-template<typename R  = void,
-         typename T1 = void,
-         typename T2 = void,
-         typename T3 = void>
+struct SignalObject { };
+typedef void (SignalObject::*SignalMethod) (void);
+
+template<typename Signature>
 struct signal
 {
 };
 
-template<typename R, typename T1, typename T2, typename T3>
-struct signal< R(), T1, T2, T3>
+template<typename R>
+struct signal<R ()>
 {
-    typedef std::function<R()> func_type;
-    void connect (func_type f) { m_func = f; }
-    R operator ()() const { m_func (); }
+    signal () : m_object (NULL), m_stub (NULL) { }
+
+    template<typename T, typename M>
+    void connect (T *object, M method)
+    {
+        m_object = object;
+        m_method = reinterpret_cast<SignalMethod> (method);
+        m_stub = &stub<T, M>;
+    }
+
+    R operator () () const
+    {
+        if (m_stub == NULL)
+            return R ();
+        return m_stub (m_object, m_method);
+    }
+
 private:
-    func_type m_func;
+    template<typename T, typename M>
+    static R stub (void *object, SignalMethod method)
+    {
+        return (static_cast<T *> (object)->*reinterpret_cast<M> (method)) ();
+    }
+
+    void *m_object;
+    SignalMethod m_method;
+    R (*m_stub) (void *, SignalMethod);
 };
 
-template<typename R, typename T1, typename T2, typename T3>
-struct signal< R(T1), T2, T3>
+template<typename R, typename T1>
+struct signal<R (T1)>
 {
-    typedef std::function<R(T1)> func_type;
-    void connect (func_type f) { m_func = f; }
-    R operator ()(T1 a1) const { return m_func (a1); }
+    signal () : m_object (NULL), m_stub (NULL) { }
+
+    template<typename T, typename M>
+    void connect (T *object, M method)
+    {
+        m_object = object;
+        m_method = reinterpret_cast<SignalMethod> (method);
+        m_stub = &stub<T, M>;
+    }
+
+    R operator () (T1 a1) const
+    {
+        if (m_stub == NULL)
+            return R ();
+        return m_stub (m_object, m_method, a1);
+    }
+
 private:
-    func_type m_func;
+    template<typename T, typename M>
+    static R stub (void *object, SignalMethod method, T1 a1)
+    {
+        return (static_cast<T *> (object)->*reinterpret_cast<M> (method)) (a1);
+    }
+
+    void *m_object;
+    SignalMethod m_method;
+    R (*m_stub) (void *, SignalMethod, T1);
 };
 
-template<typename R, typename T1, typename T2, typename T3>
-struct signal< R(T1, T2), T3>
+template<typename R, typename T1, typename T2>
+struct signal<R (T1, T2)>
 {
-    typedef std::function<R(T1, T2)> func_type;
-    void connect (func_type f) { m_func = f; }
-    R operator ()(T1 a1, T2 a2) const { return m_func (a1, a2); }
+    signal () : m_object (NULL), m_stub (NULL) { }
+
+    template<typename T, typename M>
+    void connect (T *object, M method)
+    {
+        m_object = object;
+        m_method = reinterpret_cast<SignalMethod> (method);
+        m_stub = &stub<T, M>;
+    }
+
+    R operator () (T1 a1, T2 a2) const
+    {
+        if (m_stub == NULL)
+            return R ();
+        return m_stub (m_object, m_method, a1, a2);
+    }
+
 private:
-    func_type m_func;
+    template<typename T, typename M>
+    static R stub (void *object, SignalMethod method, T1 a1, T2 a2)
+    {
+        return (static_cast<T *> (object)->*reinterpret_cast<M> (method)) (a1, a2);
+    }
+
+    void *m_object;
+    SignalMethod m_method;
+    R (*m_stub) (void *, SignalMethod, T1, T2);
 };
 
 template<typename R, typename T1, typename T2, typename T3>
-struct signal< R(T1, T2, T3)>
+struct signal<R (T1, T2, T3)>
 {
-    typedef std::function<R(T1, T2, T3)> func_type;
-    void connect (func_type f) {m_func = f; }
-    R operator ()(T1 a1, T2 a2, T3 a3) const { return m_func (a1, a2, a3); }
-private:
-    func_type m_func;
-};
-
-};
-
-#else // __GXX_EXPERIMENTAL_CXX0X__
+    signal () : m_object (NULL), m_stub (NULL) { }
+
+    template<typename T, typename M>
+    void connect (T *object, M method)
+    {
+        m_object = object;
+        m_method = reinterpret_cast<SignalMethod> (method);
+        m_stub = &stub<T, M>;
+    }
+
+    R operator () (T1 a1, T2 a2, T3 a3) const
+    {
+        if (m_stub == NULL)
+            return R ();
+        return m_stub (m_object, m_method, a1, a2, a3);
+    }
 
-#  include <boost/signals2.hpp>
-#  include <boost/bind.hpp>
-
-namespace std {
-    // import boost::bind into std namespace
-    using boost::bind;
+private:
+    template<typename T, typename M>
+    static R stub (void *object, SignalMethod method, T1 a1, T2 a2, T3 a3)
+    {
+        return (static_cast<T *> (object)->*reinterpret_cast<M> (method)) (a1, a2, a3);
+    }
+
+    void *m_object;
+    SignalMethod m_method;
+    R (*m_stub) (void *, SignalMethod, T1, T2, T3);
 };
 
-namespace PY {
-    // use boost::signal2
-    namespace bs2 = boost::signals2;
-    template <typename Signature>
-    struct signal : public bs2::signal_type
-        <Signature, bs2::keywords::mutex_type<bs2::dummy_mutex> >::type { };
-
 };
 
-#endif // __GXX_EXPERIMENTAL_CXX0X__
 #endif // __PY_SIGNAL_H_
-
@@ -0,0 +1,358 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "PYSpecialPhraseTable.h"
+
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <set>
+#include "PYFileMonitor.h"
+#include "PYString.h"
+#include "PYWorker.h"
+
+using namespace PY;
+
+struct SpecialPhraseReload {
+    std::vector<std::string> files;
+    std::shared_ptr<SpecialPhraseTable::Index> index;
+};
+
+std::unique_ptr<SpecialPhraseTable> SpecialPhraseTable::m_instance;
+
+static bool
+phrase_less (const SpecialPhraseTable::Phrase &lhs,
+             const SpecialPhraseTable::Phrase &rhs)
+{
+    return lhs.key < rhs.key;
+}
+
+SpecialPhraseTable::SpecialPhraseTable ()
+    : m_index (new Index),
+      m_reloading (FALSE),
+      m_reload_pending (FALSE)
+{
+    m_files.push_back (PKGDATADIR G_DIR_SEPARATOR_S "special_table");
+    m_files.push_back (PKGDATADIR G_DIR_SEPARATOR_S "phrases.txt");
+
+    /* the phrases in user file override the system phrases. */
+    gchar *path = g_build_filename (g_get_user_config_dir (),
+                                    "ibus", "libpinyin", "phrases.txt", NULL);
+    m_files.push_back (path);
+    g_free (path);
+
+    m_monitor.reset (new FileMonitor (m_files));
+    m_monitor->signalChanged ().connect (this, &SpecialPhraseTable::reload);
+
+    reload ();
+}
+
+SpecialPhraseTable::~SpecialPhraseTable ()
+{
+}
+
+void
+SpecialPhraseTable::init (void)
+{
+    g_assert (NULL == m_instance.get ());
+    SpecialPhraseTable * table = new SpecialPhraseTable;
+    m_instance.reset (table);
+}
+
+void
+SpecialPhraseTable::finalize (void)
+{
+    m_instance.reset ();
+}
+
+void
+SpecialPhraseTable::loadFile (const gchar *filename, Index &index)
+{
+    gchar *contents = NULL;
+    if (!g_file_get_contents (filename, &contents, NULL, NULL))
+        return;
+
+    gchar **lines = g_strsplit (contents, "\n", -1);
+    g_free (contents);
+
+    for (gchar **line = lines; *line; line++) {
+        gchar *str = g_strstrip (*line);
+        if (str[0] == '\0' || str[0] == ';' || str[0] == '#')
+            continue;
+
+        gchar *value = strchr (str, '=');
+        if (value == NULL)
+            continue;
+        *value++ = '\0';
+
+        Phrase phrase;
+        phrase.key = g_strstrip (str);
+        value = g_strstrip (value);
+        if (phrase.key.empty () || value[0] == '\0')
+            continue;
+
+        if (value[0] == '"') {
+            /* special_table: key = "phrase","phrase",... */
+            gchar **items = g_strsplit (value, ",", -1);
+            for (gchar **item = items; *item; item++) {
+                gchar *text = g_strstrip (*item);
+                gsize len = strlen (text);
+                if (len < 2 || text[0] != '"' || text[len - 1] != '"')
+                    continue;
+                phrase.text.assign (text + 1, len - 2);
+                phrase.dynamic = false;
+                /* the builtin X_ phrases are not supported. */
+                if (phrase.text.empty () ||
+                    g_str_has_prefix (phrase.text.c_str (), "X_"))
+                    continue;
+                index.push_back (phrase);
+            }
+            g_strfreev (items);
+        } else {
+            /* phrases.txt: key=phrase or key=#dynamic phrase */
+            phrase.dynamic = (value[0] == '#');
+            phrase.text = phrase.dynamic ? value + 1 : value;
+            index.push_back (phrase);
+        }
+    }
+
+    g_strfreev (lines);
+}
+
+std::shared_ptr<SpecialPhraseTable::Index>
+SpecialPhraseTable::compile (const std::vector<std::string> &files)
+{
+    std::shared_ptr<Index> index (new Index);
+
+    for (guint i = 0; i < files.size (); i++) {
+        Index phrases;
+        loadFile (files[i].c_str (), phrases);
+        if (phrases.empty ())
+            continue;
+
+        /* the later files override the keys in the earlier files. */
+        std::set<std::string> keys;
+        for (guint j = 0; j < phrases.size (); j++)
+            keys.insert (phrases[j].key);
+
+        Index::iterator end = index->begin ();
+        for (Index::iterator iter = index->begin ();
+             iter != index->end (); ++iter) {
+            if (keys.find (iter->key) == keys.end ())
+                *end++ = *iter;
+        }
+        index->erase (end, index->end ());
+        index->insert (index->end (), phrases.begin (), phrases.end ());
+    }
+
+    std::stable_sort (index->begin (), index->end (), phrase_less);
+    return index;
+}
+
+void
+SpecialPhraseTable::reload (void)
+{
+    /* reload again after the running one, the files changed meanwhile. */
+    if (m_reloading) {
+        m_reload_pending = TRUE;
+        return;
+    }
+    m_reloading = TRUE;
+    m_reload_pending = FALSE;
+
+    SpecialPhraseReload *data = new SpecialPhraseReload;
+    data->files = m_files;
+    Worker::instance ().push (reloadJob, reloadDone, reloadFree, data);
+}
+
+void
+SpecialPhraseTable::reloadJob (gpointer data)
+{
+    SpecialPhraseReload *reload = static_cast<SpecialPhraseReload *> (data);
+    reload->index = compile (reload->files);
+}
+
+void
+SpecialPhraseTable::reloadDone (gpointer data)
+{
+    SpecialPhraseReload *reload = static_cast<SpecialPhraseReload *> (data);
+    SpecialPhraseTable *table = m_instance.get ();
+
+    if (table) {
+        /* the lookups in main loop switch to the new index from now on. */
+        table->m_index = reload->index;
+        table->m_reloading = FALSE;
+        if (table->m_reload_pending)
+            table->reload ();
+    }
+}
+
+void
+SpecialPhraseTable::reloadFree (gpointer data)
+{
+    delete static_cast<SpecialPhraseReload *> (data);
+}
+
+gboolean
+SpecialPhraseTable::lookup (const std::string &key,
+                            std::vector<std::string> &result)
+{
+    Phrase phrase;
+    phrase.key = key;
+    std::pair<Index::const_iterator, Index::const_iterator> range =
+        std::equal_range (m_index->begin (), m_index->end (),
+                          phrase, phrase_less);
+
+    for (Index::const_iterator iter = range.first;
+         iter != range.second; ++iter) {
+        if (iter->dynamic)
+            result.push_back (expand (iter->text));
+        else
+            result.push_back (iter->text);
+    }
+
+    return range.first != range.second;
+}
+
+/* dynamic phrases */
+
+static const gchar * const digits_cn[] = {
+    "〇", "一", "二", "三", "四", "五", "六", "七", "八", "九"
+};
+
+static const gchar * const weekdays_cn[] = {
+    "日", "一", "二", "三", "四", "五", "六"
+};
+
+/* convert 0 - 99 to chinese number, like "二十二". */
+static void
+append_number_cn (String &str, gint num)
+{
+    if (num == 0) {
+        str << "零";
+        return;
+    }
+    if (num >= 20)
+        str << digits_cn[num / 10];
+    if (num >= 10)
+        str << "十";
+    if (num % 10)
+        str << digits_cn[num % 10];
+}
+
+static void
+append_digits_cn (String &str, gint num, gint width)
+{
+    gchar buf[16];
+    g_snprintf (buf, sizeof (buf), "%0*d", width, num);
+    for (const gchar *p = buf; *p; p++)
+        str << digits_cn[*p - '0'];
+}
+
+static gint
+half_hour (const struct tm &tm)
+{
+    gint hour = tm.tm_hour % 12;
+    return hour == 0 ? 12 : hour;
+}
+
+static gboolean
+append_variable (String &str, const std::string &name, const struct tm &tm)
+{
+    if (name == "year")
+        str.appendPrintf ("%d", tm.tm_year + 1900);
+    else if (name == "year_yy")
+        str.appendPrintf ("%02d", tm.tm_year % 100);
+    else if (name == "month")
+        str.appendPrintf ("%d", tm.tm_mon + 1);
+    else if (name == "month_mm")
+        str.appendPrintf ("%02d", tm.tm_mon + 1);
+    else if (name == "day")
+        str.appendPrintf ("%d", tm.tm_mday);
+    else if (name == "day_dd")
+        str.appendPrintf ("%02d", tm.tm_mday);
+    else if (name == "weekday")
+        str.appendPrintf ("%d", tm.tm_wday);
+    else if (name == "fullhour")
+        str.appendPrintf ("%02d", tm.tm_hour);
+    else if (name == "halfhour")
+        str.appendPrintf ("%02d", half_hour (tm));
+    else if (name == "ampm")
+        str << (tm.tm_hour < 12 ? "AM" : "PM");
+    else if (name == "minute")
+        str.appendPrintf ("%02d", tm.tm_min);
+    else if (name == "second")
+        str.appendPrintf ("%02d", tm.tm_sec);
+    else if (name == "year_cn")
+        append_digits_cn (str, tm.tm_year + 1900, 4);
+    else if (name == "year_yy_cn")
+        append_digits_cn (str, tm.tm_year % 100, 2);
+    else if (name == "month_cn")
+        append_number_cn (str, tm.tm_mon + 1);
+    else if (name == "day_cn")
+        append_number_cn (str, tm.tm_mday);
+    else if (name == "weekday_cn")
+        str << weekdays_cn[tm.tm_wday];
+    else if (name == "fullhour_cn")
+        append_number_cn (str, tm.tm_hour);
+    else if (name == "halfhour_cn")
+        append_number_cn (str, half_hour (tm));
+    else if (name == "ampm_cn")
+        str << (tm.tm_hour < 12 ? "上午" : "下午");
+    else if (name == "minute_cn" || name == "second_cn") {
+        gint num = (name == "minute_cn") ? tm.tm_min : tm.tm_sec;
+        if (num > 0 && num < 10)
+            str << "零";
+        append_number_cn (str, num);
+    }
+    else
+        return FALSE;
+    return TRUE;
+}
+
+std::string
+SpecialPhraseTable::expand (const std::string &text)
+{
+    time_t now = time (NULL);
+    struct tm tm;
+    localtime_r (&now, &tm);
+
+    String result;
+    size_t pos = 0;
+    while (pos < text.length ()) {
+        size_t begin = text.find ("${", pos);
+        if (begin == std::string::npos)
+            break;
+        size_t end = text.find ('}', begin + 2);
+        if (end == std::string::npos)
+            break;
+
+        result.append (text, pos, begin - pos);
+        std::string name = text.substr (begin + 2, end - begin - 2);
+        /* keep the unknown variables as is. */
+        if (!append_variable (result, name, tm))
+            result.append (text, begin, end + 1 - begin);
+        pos = end + 1;
+    }
+    result.append (text, pos, std::string::npos);
+
+    return result;
+}
@@ -0,0 +1,82 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef __PY_SPECIAL_PHRASE_TABLE_H_
+#define __PY_SPECIAL_PHRASE_TABLE_H_
+
+#include <string>
+#include <vector>
+#include <glib.h>
+#include "PYUtil.h"
+
+namespace PY {
+
+class FileMonitor;
+
+class SpecialPhraseTable {
+public:
+    /* one phrase, the dynamic phrases are templates like "${year}". */
+    struct Phrase {
+        std::string key;
+        std::string text;
+        bool dynamic;
+    };
+
+    /* phrases sorted by key, in the order of the files and lines. */
+    typedef std::vector<Phrase> Index;
+
+public:
+    SpecialPhraseTable ();
+    virtual ~SpecialPhraseTable ();
+
+    gboolean lookup (const std::string &key, std::vector<std::string> &result);
+    void reload (void);
+
+    /* use static initializer in C++. */
+    static SpecialPhraseTable & instance (void) { return *m_instance; }
+
+    static void init (void);
+    static void finalize (void);
+
+    static std::string expand (const std::string &text);
+    static std::shared_ptr<Index> compile (const std::vector<std::string> &files);
+
+private:
+    static void loadFile (const gchar *filename, Index &index);
+    static void reloadJob (gpointer data);
+    static void reloadDone (gpointer data);
+    static void reloadFree (gpointer data);
+
+private:
+    std::vector<std::string> m_files;
+    std::shared_ptr<Index> m_index;
+
+    /* compile the index in a worker thread, and swap it in main loop. */
+    std::unique_ptr<FileMonitor> m_monitor;
+    gboolean m_reloading;
+    gboolean m_reload_pending;
+
+private:
+    static std::unique_ptr<SpecialPhraseTable> m_instance;
+};
+
+};
+
+#endif
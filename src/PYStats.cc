@@ -0,0 +1,49 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "PYStats.h"
+
+namespace PY {
+
+gboolean Stats::m_enabled = FALSE;
+guint Stats::m_texts = 0;
+guint Stats::m_text_cache_hits = 0;
+guint Stats::m_text_cache_misses = 0;
+gsize Stats::m_text_cache_bytes = 0;
+
+void
+Stats::reset (void)
+{
+    m_texts = 0;
+    m_text_cache_hits = 0;
+    m_text_cache_misses = 0;
+}
+
+void
+Stats::report (guint keyval, guint serialized_candidates)
+{
+    guint lookups = m_text_cache_hits + m_text_cache_misses;
+    g_message ("key 0x%04x: %u candidates serialized, %u texts created, "
+               "text cache %u/%u hits, %" G_GSIZE_FORMAT " bytes",
+               keyval, serialized_candidates, m_texts,
+               m_text_cache_hits, lookups, m_text_cache_bytes);
+}
+
+};
@@ -0,0 +1,70 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef __PY_STATS_H_
+#define __PY_STATS_H_
+
+#include <glib.h>
+
+namespace PY {
+
+/* counters of the key event path, to check the payload and the
+ * allocations of every key event. They are logged after each key
+ * event when the engine runs with --verbose. */
+class Stats {
+public:
+    static gboolean enabled (void) { return m_enabled; }
+    static void setEnabled (gboolean enabled) { m_enabled = enabled; }
+
+    /* called before each key event. */
+    static void reset (void);
+    static void report (guint keyval, guint serialized_candidates);
+
+    /* IBusText objects created by the key event. */
+    static void addTexts (guint count) { m_texts += count; }
+    static guint texts (void) { return m_texts; }
+
+    /* candidate text cache lookups of the key event. */
+    static void addTextCacheLookup (gboolean hit)
+    {
+        if (hit)
+            m_text_cache_hits++;
+        else
+            m_text_cache_misses++;
+    }
+    static guint textCacheHits (void) { return m_text_cache_hits; }
+    static guint textCacheMisses (void) { return m_text_cache_misses; }
+
+    /* bytes held by all the candidate text caches. */
+    static void addTextCacheBytes (gsize bytes) { m_text_cache_bytes += bytes; }
+    static void removeTextCacheBytes (gsize bytes) { m_text_cache_bytes -= bytes; }
+    static gsize textCacheBytes (void) { return m_text_cache_bytes; }
+
+private:
+    static gboolean m_enabled;
+    static guint m_texts;
+    static guint m_text_cache_hits;
+    static guint m_text_cache_misses;
+    static gsize m_text_cache_bytes;
+};
+
+};
+
+#endif
@@ -36,30 +36,23 @@ public:
 
     String & printf (const gchar *fmt, ...)
     {
-        gchar *str;
         va_list args;
 
         va_start (args, fmt);
-        str = g_strdup_vprintf (fmt, args);
+        formatv (FALSE, fmt, args);
         va_end (args);
 
-        assign (str);
-        g_free (str);
         return *this;
     }
 
     String & appendPrintf (const gchar *fmt, ...)
     {
-        gchar *str;
         va_list args;
 
         va_start (args, fmt);
-        str = g_strdup_vprintf (fmt, args);
+        formatv (TRUE, fmt, args);
         va_end (args);
 
-        append (str);
-        g_free (str);
-
         return *this;
     }
 
@@ -92,12 +85,12 @@ public:
 
     String & operator<< (gint i)
     {
-        return appendPrintf ("%d", i);
+        return appendNumber (i < 0 ? - (guint) i : (guint) i, i < 0);
     }
 
     String & operator<< (guint i)
     {
-        return appendPrintf ("%u", i);
+        return appendNumber (i, FALSE);
     }
 
     String & operator<< (const gchar ch)
@@ -158,6 +151,50 @@ public:
     {
         return ! empty ();
     }
+
+private:
+    String & formatv (gboolean append_mode, const gchar *fmt, va_list args)
+    {
+        /* format short strings on stack, and avoid the heap allocation. */
+        gchar buf[256];
+        va_list copy;
+
+        G_VA_COPY (copy, args);
+        gint len = g_vsnprintf (buf, sizeof (buf), fmt, copy);
+        va_end (copy);
+
+        if (G_LIKELY (len >= 0 && len < (gint) sizeof (buf))) {
+            if (append_mode)
+                append (buf, len);
+            else
+                assign (buf, len);
+            return *this;
+        }
+
+        gchar *str = g_strdup_vprintf (fmt, args);
+        if (append_mode)
+            append (str);
+        else
+            assign (str);
+        g_free (str);
+        return *this;
+    }
+
+    String & appendNumber (guint num, gboolean negative)
+    {
+        gchar buf[12];
+        gchar *p = buf + sizeof (buf);
+
+        do {
+            *--p = '0' + num % 10;
+            num /= 10;
+        } while (num);
+        if (negative)
+            *--p = '-';
+
+        append (p, buf + sizeof (buf) - p);
+        return *this;
+    }
 };
 
 };
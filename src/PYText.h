@@ -21,9 +21,11 @@
 #ifndef __PY_TEXT_H_
 #define __PY_TEXT_H_
 
+#include <cstring>
 #include <string>
 #include <ibus.h>
 #include "PYObject.h"
+#include "PYStats.h"
 
 namespace PY {
 
@@ -73,6 +75,97 @@ public:
     }
 };
 
+/* the IBusText of preedit or auxiliary text, reused by the updates while
+ * the string and the underline stay the same. A shown IBusText is never
+ * modified, a changed string gets a new one. */
+class PooledText {
+public:
+    PooledText (void) : m_underline (FALSE) { }
+
+    IBusText * reset (const gchar *str, gboolean underline = FALSE)
+    {
+        IBusText *text = m_text;
+        if (text == NULL || underline != m_underline ||
+            g_strcmp0 (ibus_text_get_text (text), str) != 0) {
+            text = ibus_text_new_from_string (str);
+            /* the underline attributes are shared by all texts. */
+            if (underline)
+                ibus_text_set_attributes (text, underlineAttributes ());
+            m_text = text;
+            m_underline = underline;
+            Stats::addTexts (1);
+        }
+        return text;
+    }
+
+private:
+    static IBusAttrList * underlineAttributes (void)
+    {
+        static Pointer<IBusAttrList> attrs;
+        if ((IBusAttrList *) attrs == NULL) {
+            attrs = ibus_attr_list_new ();
+            ibus_attr_list_append (attrs,
+                ibus_attr_underline_new (IBUS_ATTR_UNDERLINE_SINGLE, 0, -1));
+        }
+        return attrs;
+    }
+
+private:
+    Pointer<IBusText> m_text;
+    gboolean m_underline;
+};
+
+/* IBusText objects of candidates keyed by their source string, so the
+ * lookup table appends the same objects over consecutive key events.
+ * At most max_bytes are kept, the cache is dropped when full. */
+class TextCache {
+public:
+    TextCache (gsize max_bytes = 256 * 1024)
+        : m_table (g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free, g_object_unref)),
+          m_max_bytes (max_bytes),
+          m_bytes (0) { }
+
+    ~TextCache (void)
+    {
+        Stats::removeTextCacheBytes (m_bytes);
+        g_hash_table_unref (m_table);
+    }
+
+    IBusText * lookup (const gchar *key)
+    {
+        IBusText *text = (IBusText *) g_hash_table_lookup (m_table, key);
+        Stats::addTextCacheLookup (text != NULL);
+        return text;
+    }
+
+    IBusText * insert (const gchar *key, IBusText *text)
+    {
+        /* the key copy, the text object and its string. */
+        gsize bytes = strlen (key) + 1 + sizeof (IBusText) +
+            strlen (ibus_text_get_text (text)) + 1;
+        if (G_UNLIKELY (m_bytes + bytes > m_max_bytes)) {
+            g_hash_table_remove_all (m_table);
+            Stats::removeTextCacheBytes (m_bytes);
+            m_bytes = 0;
+        }
+        g_object_ref_sink (text);
+        g_hash_table_insert (m_table, g_strdup (key), text);
+        m_bytes += bytes;
+        Stats::addTexts (1);
+        Stats::addTextCacheBytes (bytes);
+        return text;
+    }
+
+private:
+    TextCache (const TextCache &);
+    TextCache & operator = (const TextCache &);
+
+    GHashTable *m_table;
+    gsize m_max_bytes;
+    gsize m_bytes;
+};
+
 };
 
 #endif
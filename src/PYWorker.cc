@@ -0,0 +1,193 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#include "PYWorker.h"
+
+namespace PY {
+
+std::unique_ptr<Worker> Worker::m_instance;
+
+Worker::Worker ()
+    : m_head (0),
+      m_tail (0),
+      m_done_id (0),
+      m_sleeping (FALSE),
+      m_quit (FALSE)
+{
+    g_mutex_init (&m_mutex);
+    g_cond_init (&m_cond);
+    g_queue_init (&m_overflow);
+    g_queue_init (&m_done);
+    m_thread = g_thread_new ("worker", run, this);
+}
+
+Worker::~Worker ()
+{
+    /* the queued jobs are still run, their done callbacks are not. */
+    g_mutex_lock (&m_mutex);
+    m_quit = TRUE;
+    g_cond_signal (&m_cond);
+    g_mutex_unlock (&m_mutex);
+
+    g_thread_join (m_thread);
+
+    if (m_done_id != 0)
+        g_source_remove (m_done_id);
+    Task *task;
+    while ((task = static_cast<Task *> (g_queue_pop_head (&m_done))) != NULL) {
+        if (task->free)
+            task->free (task->data);
+        delete task;
+    }
+
+    g_cond_clear (&m_cond);
+    g_mutex_clear (&m_mutex);
+}
+
+void
+Worker::init (void)
+{
+    g_assert (NULL == m_instance.get ());
+    m_instance.reset (new Worker);
+}
+
+void
+Worker::finalize (void)
+{
+    m_instance.reset ();
+}
+
+void
+Worker::push (Job job, Done done, Free free, gpointer data)
+{
+    g_mutex_lock (&m_mutex);
+
+    gint tail = g_atomic_int_get (&m_tail);
+    gint next = (tail + 1) % QUEUE_SIZE;
+
+    if (G_LIKELY (g_queue_is_empty (&m_overflow) &&
+                  next != g_atomic_int_get (&m_head))) {
+        Task &task = m_tasks[tail];
+        task.job = job;
+        task.done = done;
+        task.free = free;
+        task.data = data;
+        /* publish the task, g_atomic_int_set is a full barrier. */
+        g_atomic_int_set (&m_tail, next);
+    } else {
+        /* the ring is full, queue behind it to keep the order. */
+        Task *task = new Task;
+        task->job = job;
+        task->done = done;
+        task->free = free;
+        task->data = data;
+        g_queue_push_tail (&m_overflow, task);
+    }
+
+    if (m_sleeping)
+        g_cond_signal (&m_cond);
+    g_mutex_unlock (&m_mutex);
+}
+
+gboolean
+Worker::pop (Task &task)
+{
+    /* the tasks in the ring are older than the overflowed ones, the
+       ring is only pushed to while the overflow queue is empty. */
+    gint head = g_atomic_int_get (&m_head);
+    if (head != g_atomic_int_get (&m_tail)) {
+        task = m_tasks[head];
+        g_atomic_int_set (&m_head, (head + 1) % QUEUE_SIZE);
+        return TRUE;
+    }
+
+    g_mutex_lock (&m_mutex);
+    while (TRUE) {
+        /* check the ring again with the lock, push may have filled it. */
+        head = g_atomic_int_get (&m_head);
+        if (head != g_atomic_int_get (&m_tail)) {
+            task = m_tasks[head];
+            g_atomic_int_set (&m_head, (head + 1) % QUEUE_SIZE);
+            break;
+        }
+
+        Task *overflow = static_cast<Task *> (g_queue_pop_head (&m_overflow));
+        if (overflow) {
+            task = *overflow;
+            delete overflow;
+            break;
+        }
+
+        if (m_quit) {
+            g_mutex_unlock (&m_mutex);
+            return FALSE;
+        }
+
+        m_sleeping = TRUE;
+        g_cond_wait (&m_cond, &m_mutex);
+        m_sleeping = FALSE;
+    }
+    g_mutex_unlock (&m_mutex);
+    return TRUE;
+}
+
+gpointer
+Worker::run (gpointer data)
+{
+    Worker *self = static_cast<Worker *> (data);
+    Task task;
+
+    while (self->pop (task)) {
+        task.job (task.data);
+
+        /* one idle source calls the done callbacks in order. */
+        g_mutex_lock (&self->m_mutex);
+        g_queue_push_tail (&self->m_done, new Task (task));
+        if (!self->m_quit && self->m_done_id == 0)
+            self->m_done_id = g_idle_add (doneCallback, self);
+        g_mutex_unlock (&self->m_mutex);
+    }
+    return NULL;
+}
+
+gboolean
+Worker::doneCallback (gpointer data)
+{
+    Worker *self = static_cast<Worker *> (data);
+    GQueue done;
+
+    g_mutex_lock (&self->m_mutex);
+    done = self->m_done;
+    g_queue_init (&self->m_done);
+    self->m_done_id = 0;
+    g_mutex_unlock (&self->m_mutex);
+
+    Task *task;
+    while ((task = static_cast<Task *> (g_queue_pop_head (&done))) != NULL) {
+        if (task->done)
+            task->done (task->data);
+        if (task->free)
+            task->free (task->data);
+        delete task;
+    }
+    return FALSE;
+}
+
+};
@@ -0,0 +1,95 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+#ifndef __PY_WORKER_H_
+#define __PY_WORKER_H_
+
+#include <glib.h>
+#include "PYUtil.h"
+
+namespace PY {
+
+/* One worker thread for the self-contained slow jobs of the engine,
+ * like reloads, exports and clearing the user data on disk. Jobs are
+ * pushed from main loop into a single producer single consumer ring,
+ * run in order by the worker, and their done callbacks are called in
+ * main loop in the same order. The libpinyin contexts are not thread
+ * safe, so parsing, guessing and training stay in main loop. */
+class Worker {
+public:
+    /* runs in the worker thread. */
+    typedef void (*Job) (gpointer data);
+    /* runs in main loop after the job. */
+    typedef void (*Done) (gpointer data);
+    /* runs in main loop last, also when done is skipped at exit. */
+    typedef void (*Free) (gpointer data);
+
+    Worker ();
+    virtual ~Worker ();
+
+    /* only call from main loop. */
+    void push (Job job, Done done, Free free, gpointer data);
+
+    /* use static initializer in C++. */
+    static Worker & instance (void) { return *m_instance; }
+
+    static void init (void);
+    static void finalize (void);
+
+private:
+    struct Task {
+        Job job;
+        Done done;
+        Free free;
+        gpointer data;
+    };
+
+    enum { QUEUE_SIZE = 64 };
+
+    gboolean pop (Task &task);
+    static gpointer run (gpointer data);
+    static gboolean doneCallback (gpointer data);
+
+private:
+    Task m_tasks[QUEUE_SIZE];
+    /* m_head is only written by the worker, m_tail by main loop. */
+    volatile gint m_head;
+    volatile gint m_tail;
+
+    /* the members below are protected by m_mutex. */
+    GMutex m_mutex;
+    /* the worker sleeps on m_cond when there is no task. */
+    GCond m_cond;
+    /* the tasks pushed while the ring is full, run after the ring. */
+    GQueue m_overflow;
+    /* the finished tasks, waiting for m_done_id in main loop. */
+    GQueue m_done;
+    guint m_done_id;
+    gboolean m_sleeping;
+    gboolean m_quit;
+    GThread *m_thread;
+
+private:
+    static std::unique_ptr<Worker> m_instance;
+};
+
+};
+
+#endif
@@ -0,0 +1,111 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/* compare the dispatch cost of PY::signal with std::function and boost::signals2. */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <glib.h>
+#include "PYSignal.h"
+
+#ifdef __GXX_EXPERIMENTAL_CXX0X__
+#  include <functional>
+#endif
+#ifdef HAVE_BOOST
+#  include <boost/bind.hpp>
+#  include <boost/signals2.hpp>
+#endif
+
+#define BENCHMARK_ROUNDS    (10 * 1000 * 1000)
+
+class Receiver {
+public:
+    Receiver () : m_sum (0) { }
+
+    void updatePreeditText (int &text, guint cursor, gboolean visible)
+    {
+        m_sum += text + cursor + visible;
+    }
+
+    guint64 m_sum;
+};
+
+static void
+report (const char *name, GTimer *timer, guint64 sum)
+{
+    gdouble elapsed = g_timer_elapsed (timer, NULL);
+    printf ("%-20s %8.2f ns/call (%" G_GUINT64_FORMAT ")\n", name,
+            elapsed * 1e9 / BENCHMARK_ROUNDS, sum);
+}
+
+int
+main (int argc, char *argv[])
+{
+    GTimer *timer = g_timer_new ();
+    int text = 1;
+
+    {
+        Receiver receiver;
+        PY::signal <void (int &, guint, gboolean)> signal;
+        signal.connect (&receiver, &Receiver::updatePreeditText);
+
+        g_timer_start (timer);
+        for (guint i = 0; i < BENCHMARK_ROUNDS; i++)
+            signal (text, i, TRUE);
+        report ("PY::signal", timer, receiver.m_sum);
+    }
+
+#ifdef __GXX_EXPERIMENTAL_CXX0X__
+    {
+        Receiver receiver;
+        std::function<void (int &, guint, gboolean)> func =
+            std::bind (&Receiver::updatePreeditText, &receiver,
+                       std::placeholders::_1,
+                       std::placeholders::_2,
+                       std::placeholders::_3);
+
+        g_timer_start (timer);
+        for (guint i = 0; i < BENCHMARK_ROUNDS; i++)
+            func (text, i, TRUE);
+        report ("std::function", timer, receiver.m_sum);
+    }
+#endif
+
+#ifdef HAVE_BOOST
+    {
+        Receiver receiver;
+        boost::signals2::signal_type <void (int &, guint, gboolean),
+            boost::signals2::keywords::mutex_type<boost::signals2::dummy_mutex> >::type signal;
+        signal.connect (boost::bind (&Receiver::updatePreeditText, &receiver, _1, _2, _3));
+
+        g_timer_start (timer);
+        for (guint i = 0; i < BENCHMARK_ROUNDS; i++)
+            signal (text, i, TRUE);
+        report ("boost::signals2", timer, receiver.m_sum);
+    }
+#endif
+
+    g_timer_destroy (timer);
+    return 0;
+}
@@ -0,0 +1,395 @@
+/* vim:set et ts=4 sts=4:
+ *
+ * ibus-libpinyin - Intelligent Pinyin engine based on libpinyin for IBus
+ *
+ * Copyright (c) 2011 Peng Wu <alexepico@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/* measure the cold start of ibus-engine-libpinyin against a private
+ * ibus-daemon, from process start to the first lookup table. The daemon
+ * and the engine run with temporary XDG dirs and the in-memory config,
+ * so the user dictionary and the config of the user are never touched. */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <vector>
+#include <glib/gstdio.h>
+#include <ibus.h>
+
+#define BENCHMARK_ENGINE    "libpinyin-debug"
+#define BENCHMARK_TIMEOUT   (30 * G_USEC_PER_SEC)
+#define BENCHMARK_INTERVAL  (1000)
+
+/* options */
+static gchar *engine_path = (gchar *) "./ibus-engine-libpinyin";
+static gchar *daemon_path = (gchar *) "ibus-daemon";
+static gchar *config_name = (gchar *) "memconf";
+static gchar *dictionaries = (gchar *) "";
+static gint rounds = 5;
+
+static const GOptionEntry entries[] =
+{
+    { "engine", 'e', 0, G_OPTION_ARG_FILENAME, &engine_path, "engine executable", "PATH" },
+    { "daemon", 'd', 0, G_OPTION_ARG_FILENAME, &daemon_path, "ibus-daemon executable", "PATH" },
+    { "config", 'c', 0, G_OPTION_ARG_STRING, &config_name, "config of the private ibus-daemon, memconf or a config executable", "NAME" },
+    { "dictionaries", 'D', 0, G_OPTION_ARG_STRING, &dictionaries, "addon dictionaries to load, like \"2;3;4\"", "LIST" },
+    { "rounds", 'n', 0, G_OPTION_ARG_INT, &rounds, "number of cold starts", "N" },
+    { NULL },
+};
+
+enum {
+    PHASE_START = 0,        // process start until the engine is registered
+    PHASE_CREATE,           // engine creation, loads the libpinyin tables
+    PHASE_FOCUS_IN,         // focus in until the first key event returns
+    PHASE_LOOKUP_TABLE,     // first key event sent until the lookup table
+    PHASE_LAST,
+};
+
+static const gchar * const phase_names[PHASE_LAST] = {
+    "process start",
+    "engine creation",
+    "focus in + key",
+    "key to lookup table",
+};
+
+typedef gboolean (*Condition) (gpointer data);
+
+/* run main loop until condition is met, FALSE on timeout. */
+static gboolean
+wait_for (Condition condition, gpointer data)
+{
+    gint64 deadline = g_get_monotonic_time () + BENCHMARK_TIMEOUT;
+    while (!condition (data)) {
+        if (g_get_monotonic_time () > deadline)
+            return FALSE;
+        if (!g_main_context_iteration (NULL, FALSE))
+            g_usleep (BENCHMARK_INTERVAL);
+    }
+    return TRUE;
+}
+
+static gboolean
+bus_connected (gpointer data)
+{
+    IBusBus **bus = (IBusBus **) data;
+    if (*bus == NULL)
+        *bus = ibus_bus_new ();
+    if (ibus_bus_is_connected (*bus))
+        return TRUE;
+    g_object_unref (*bus);
+    *bus = NULL;
+    return FALSE;
+}
+
+static gboolean
+engine_registered (gpointer data)
+{
+    IBusBus *bus = (IBusBus *) data;
+    gboolean found = FALSE;
+    GList *engines = ibus_bus_list_engines (bus);
+    for (GList *p = engines; p != NULL; p = p->next) {
+        IBusEngineDesc *desc = (IBusEngineDesc *) p->data;
+        if (g_strcmp0 (ibus_engine_desc_get_name (desc), BENCHMARK_ENGINE) == 0)
+            found = TRUE;
+        g_object_unref (desc);
+    }
+    g_list_free (engines);
+    return found;
+}
+
+static gboolean
+engine_created (gpointer data)
+{
+    IBusInputContext *context = (IBusInputContext *) data;
+    IBusEngineDesc *desc = ibus_input_context_get_engine (context);
+    return desc != NULL;
+}
+
+static gboolean
+flag_set (gpointer data)
+{
+    return *(gboolean *) data;
+}
+
+static void
+update_lookup_table_cb (IBusInputContext *context,
+                        IBusLookupTable  *table,
+                        gboolean          visible,
+                        gboolean         *updated)
+{
+    if (visible && ibus_lookup_table_get_number_of_candidates (table) > 0)
+        *updated = TRUE;
+}
+
+static void
+stop_process (GPid pid)
+{
+    kill (pid, SIGTERM);
+    waitpid (pid, NULL, 0);
+    g_spawn_close_pid (pid);
+}
+
+/* the install dirs of ibus-memconf in the distributions. */
+static const gchar * const memconf_paths[] = {
+    "/usr/libexec/ibus-memconf",
+    "/usr/lib/ibus/ibus-memconf",
+    "/usr/local/libexec/ibus-memconf",
+};
+
+static gchar *
+find_memconf (void)
+{
+    gchar *path = g_find_program_in_path ("ibus-memconf");
+    for (guint i = 0; path == NULL && i < G_N_ELEMENTS (memconf_paths); i++) {
+        if (g_file_test (memconf_paths[i], G_FILE_TEST_IS_EXECUTABLE))
+            path = g_strdup (memconf_paths[i]);
+    }
+    return path;
+}
+
+static void
+remove_dir (const gchar *path)
+{
+    GDir *dir = g_dir_open (path, 0, NULL);
+    if (dir) {
+        const gchar *name;
+        while ((name = g_dir_read_name (dir)) != NULL) {
+            gchar *child = g_build_filename (path, name, NULL);
+            if (g_file_test (child, G_FILE_TEST_IS_DIR) &&
+                !g_file_test (child, G_FILE_TEST_IS_SYMLINK))
+                remove_dir (child);
+            else
+                g_unlink (child);
+            g_free (child);
+        }
+        g_dir_close (dir);
+    }
+    g_rmdir (path);
+}
+
+static gboolean
+run_round (IBusBus *bus, gdouble *times)
+{
+    gchar *argv[] = { engine_path, NULL };
+    GPid pid;
+    GError *error = NULL;
+
+    GTimer *timer = g_timer_new ();
+    GTimer *key_timer = g_timer_new ();
+    if (!g_spawn_async (NULL, argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD,
+                        NULL, NULL, &pid, &error)) {
+        g_warning ("Can not start %s: %s", engine_path, error->message);
+        g_error_free (error);
+        g_timer_destroy (key_timer);
+        g_timer_destroy (timer);
+        return FALSE;
+    }
+
+    gboolean retval = FALSE;
+    gboolean updated = FALSE;
+    IBusInputContext *context = NULL;
+
+    if (!wait_for (engine_registered, bus))
+        goto out;
+    times[PHASE_START] = g_timer_elapsed (timer, NULL);
+
+    context = ibus_bus_create_input_context (bus, "benchmark-startup");
+    if (context == NULL)
+        goto out;
+    ibus_input_context_set_capabilities (context,
+        IBUS_CAP_PREEDIT_TEXT | IBUS_CAP_AUXILIARY_TEXT |
+        IBUS_CAP_LOOKUP_TABLE | IBUS_CAP_FOCUS);
+    g_signal_connect (context, "update-lookup-table",
+                      G_CALLBACK (update_lookup_table_cb), &updated);
+
+    g_timer_start (timer);
+    ibus_input_context_set_engine (context, BENCHMARK_ENGINE);
+    if (!wait_for (engine_created, context))
+        goto out;
+    times[PHASE_CREATE] = g_timer_elapsed (timer, NULL);
+
+    /* focus in is not replied, the key event is handled after it by the
+     * engine, and its reply comes after the candidates are guessed. */
+    g_timer_start (timer);
+    ibus_input_context_focus_in (context);
+    g_timer_start (key_timer);
+    ibus_input_context_process_key_event (context, IBUS_n, 0, 0);
+    times[PHASE_FOCUS_IN] = g_timer_elapsed (timer, NULL);
+
+    if (!wait_for (flag_set, &updated))
+        goto out;
+    times[PHASE_LOOKUP_TABLE] = g_timer_elapsed (key_timer, NULL);
+
+    retval = TRUE;
+
+out:
+    if (!retval)
+        g_warning ("Timeout in round, engine %s.", engine_path);
+    if (context) {
+        ibus_proxy_destroy ((IBusProxy *) context);
+        g_object_unref (context);
+    }
+    stop_process (pid);
+    g_timer_destroy (key_timer);
+    g_timer_destroy (timer);
+    return retval;
+}
+
+static void
+report (std::vector<gdouble> *times)
+{
+    printf ("%-20s %10s %10s %10s\n", "phase (ms)", "min", "median", "max");
+    for (guint i = 0; i < PHASE_LAST; i++) {
+        std::vector<gdouble> &values = times[i];
+        std::sort (values.begin (), values.end ());
+        printf ("%-20s %10.2f %10.2f %10.2f\n", phase_names[i],
+                values.front () * 1e3,
+                values[values.size () / 2] * 1e3,
+                values.back () * 1e3);
+    }
+}
+
+int
+main (gint argc, gchar **argv)
+{
+    GError *error = NULL;
+    GOptionContext *option_context;
+
+    option_context = g_option_context_new ("- measure ibus-libpinyin cold start");
+    g_option_context_add_main_entries (option_context, entries, "ibus-libpinyin");
+    if (!g_option_context_parse (option_context, &argc, &argv, &error)) {
+        g_print ("Option parsing failed: %s\n", error->message);
+        exit (-1);
+    }
+    g_option_context_free (option_context);
+
+    /* the daemon and the engine inherit the temporary XDG dirs. */
+    gchar *tmpdir = g_dir_make_tmp ("ibus-benchmark-XXXXXX", &error);
+    if (tmpdir == NULL) {
+        g_print ("Can not create temporary dir: %s\n", error->message);
+        exit (-1);
+    }
+    const gchar * const xdg_dirs[] = {
+        "XDG_CONFIG_HOME", "XDG_CACHE_HOME", "XDG_DATA_HOME",
+    };
+    for (guint i = 0; i < G_N_ELEMENTS (xdg_dirs); i++) {
+        gchar *dir = g_build_filename (tmpdir, xdg_dirs[i], NULL);
+        g_mkdir_with_parents (dir, 0700);
+        g_setenv (xdg_dirs[i], dir, TRUE);
+        g_free (dir);
+    }
+
+    ibus_init ();
+
+    /* the daemon runs the config executable, "default" is the dconf of
+     * the user and is refused. */
+    gchar *config = g_strcmp0 (config_name, "memconf") == 0 ?
+        find_memconf () : g_strdup (config_name);
+    if (config == NULL || g_strcmp0 (config, "default") == 0) {
+        g_print ("No private config for ibus-daemon, use --config.\n");
+        remove_dir (tmpdir);
+        exit (-1);
+    }
+
+    /* start a private ibus-daemon, the engine inherits IBUS_ADDRESS. */
+    gchar *address = g_strdup_printf ("unix:path=%s/ibus-benchmark",
+                                      tmpdir);
+    gchar *config_arg = g_strdup_printf ("--config=%s", config);
+    gchar *address_arg = g_strdup_printf ("--address=%s", address);
+    gchar *daemon_argv[] = {
+        daemon_path, (gchar *) "--panel=disable", (gchar *) "--cache=none",
+        config_arg, address_arg, NULL
+    };
+    g_setenv ("IBUS_ADDRESS", address, TRUE);
+
+    GPid daemon_pid;
+    if (!g_spawn_async (NULL, daemon_argv, NULL,
+                        (GSpawnFlags) (G_SPAWN_DO_NOT_REAP_CHILD | G_SPAWN_SEARCH_PATH),
+                        NULL, NULL, &daemon_pid, &error)) {
+        g_print ("Can not start %s: %s\n", daemon_path, error->message);
+        remove_dir (tmpdir);
+        exit (-1);
+    }
+
+    IBusBus *bus = NULL;
+    if (!wait_for (bus_connected, &bus)) {
+        g_print ("Can not connect to private ibus-daemon.\n");
+        stop_process (daemon_pid);
+        remove_dir (tmpdir);
+        exit (-1);
+    }
+
+    /* always set, the config may keep the value of another run. */
+    IBusConfig *ibus_config = ibus_bus_get_config (bus);
+    if (ibus_config == NULL ||
+        !ibus_config_set_value (ibus_config, "engine/pinyin", "Dictionaries",
+                                g_variant_new_string (dictionaries))) {
+        g_print ("Can not set the dictionaries in %s.\n", config);
+        g_object_unref (bus);
+        stop_process (daemon_pid);
+        remove_dir (tmpdir);
+        exit (-1);
+    }
+
+    printf ("engine: %s\nconfig: %s\ndictionaries: %s\n", engine_path,
+            config, dictionaries);
+#ifdef IBUS_BUILD_LUA_EXTENSION
+    printf ("lua: yes\n");
+#else
+    printf ("lua: no\n");
+#endif
+#ifdef HAVE_OPENCC
+    printf ("opencc: yes\n");
+#else
+    printf ("opencc: no\n");
+#endif
+
+    std::vector<gdouble> times[PHASE_LAST];
+    gint failed = 0;
+    for (gint i = 0; i < rounds; i++) {
+        gdouble round_times[PHASE_LAST];
+        if (!run_round (bus, round_times)) {
+            failed++;
+            continue;
+        }
+        for (guint j = 0; j < PHASE_LAST; j++)
+            times[j].push_back (round_times[j]);
+    }
+
+    if (!times[0].empty ())
+        report (times);
+
+    g_object_unref (bus);
+    stop_process (daemon_pid);
+    remove_dir (tmpdir);
+    g_free (address_arg);
+    g_free (config_arg);
+    g_free (address);
+    g_free (config);
+    g_free (tmpdir);
+    return failed == 0 ? 0 : 1;
+}